@@ -10,8 +10,12 @@
 #include <iostream>
 #include <fstream>
 #include <string>
-#include <dirent.h>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <sys/stat.h>
 #include <cstdlib>
+#include <cerrno>
 #include <unistd.h> // For getting the current working directory
 #include <getopt.h> // For command-line option parsing
 #include <rapidjson/document.h>
@@ -20,52 +24,97 @@
 #include "spdlog/sinks/stdout_color_sinks.h" // For logging
 #include "spdlog/sinks/basic_file_sink.h"    // Include for file logging
 #include "utils/TableMigrationTool.h"        // Include the TableMigrationTool header
+#include "utils/TableProcessor.h"            // Per-table check/delete/create sequence
+#include "utils/EventLoop.h"                 // Drives all remote calls
+#include "utils/DynamoDBClient.h"            // AWS CLI or built-in HTTP backend
+#include "utils/HttpClient.h"                // Connection pool settings and counters
+#include "utils/TableWaiter.h"               // Delete/ACTIVE waiter settings
+#include "utils/Preflight.h"                 // Local checks before any remote call
+#include "utils/DefinitionCache.h"           // Skips files unchanged since the last run
+#include "utils/TenantTemplate.h"            // Per-tenant copies of template definitions
+#include "utils/DefinitionScanner.h"         // Finds definition files, in the background
+#include "utils/Sharding.h"                  // Splits one migration across runners
+#include "utils/DefinitionWatcher.h"         // File change events for --watch
+#include "utils/MappedFile.h"                // Reads definition files
+#include "utils/DefinitionFilter.h"          // --include and --exclude patterns
+#include "utils/SigV4.h"                     // Region for the cache key
 
 // Namespaces
 using namespace std;
 using namespace rapidjson;
 
+// Options without a short form
+enum LongOption
+{
+    OPT_WAIT_TIMEOUT = 256,
+    OPT_MAX_PENDING_TABLES,
+    OPT_KEEP_GOING,
+    OPT_NO_CACHE,
+    OPT_TENANTS,
+    OPT_RECURSIVE,
+    OPT_SHARD,
+    OPT_LIST_SHARDS,
+    OPT_WATCH,
+    OPT_INCLUDE,
+    OPT_EXCLUDE,
+};
+
+// How long --watch waits for a burst of saves to end
+const chrono::milliseconds watchDebounce(300);
+
 int main(int argc, char *argv[])
 {
     // Parse command-line options
-    const char *const short_opts = "hp:fd";
+    const char *const short_opts = "hp:fdj:e:c:w";
     const option long_opts[] = {
         {"help", no_argument, nullptr, 'h'},
         {"path", required_argument, nullptr, 'p'},
-        {"force", no_argument, nullptr, 'f'}, // Add force option
-        {"debug", no_argument, nullptr, 'd'}, // Add debug option
+        {"force", no_argument, nullptr, 'f'},       // Add force option
+        {"debug", no_argument, nullptr, 'd'},       // Add debug option
+        {"jobs", required_argument, nullptr, 'j'},  // Number of tables processed concurrently
+        {"endpoint-url", required_argument, nullptr, 'e'},
+        {"max-connections", required_argument, nullptr, 'c'},
+        {"wait-active", no_argument, nullptr, 'w'},
+        {"wait-timeout", required_argument, nullptr, OPT_WAIT_TIMEOUT},
+        {"max-pending-tables", required_argument, nullptr, OPT_MAX_PENDING_TABLES},
+        {"keep-going", no_argument, nullptr, OPT_KEEP_GOING},
+        {"no-cache", no_argument, nullptr, OPT_NO_CACHE},
+        {"tenants", required_argument, nullptr, OPT_TENANTS},
+        {"recursive", no_argument, nullptr, OPT_RECURSIVE},
+        {"shard", required_argument, nullptr, OPT_SHARD},
+        {"list-shards", no_argument, nullptr, OPT_LIST_SHARDS},
+        {"watch", no_argument, nullptr, OPT_WATCH},
+        {"include", required_argument, nullptr, OPT_INCLUDE},
+        {"exclude", required_argument, nullptr, OPT_EXCLUDE},
+        {nullptr, 0, nullptr, 0},
     };
 
     string jsonDir;
+    unsigned long jobs = 1;
+    unsigned long maxPendingTables = 0;
+    bool keepGoing = false;
+    bool useCache = true;
+    vector<string> tenants;
+    bool recursive = false;
+    ShardSpec shard;
+    bool listShardsOnly = false;
+    bool watch = false;
+    DefinitionFilter filter;
+    string endpointUrl;
 
     // Print banner
     printBanner();
 
-// Set application directory to AppData on Windows, home directory on Linux
-#ifdef _WIN32
-    appDir = getenv("APPDATA") + string("\\DynamoDB-Table-Migration-Tool");
+    // Set application directory to the home directory
+    appDir = getenv("HOME") + string("/.DynamoDB-Table-Migration-Tool");
+    tempDir = appDir + string("/temp");
 
     // Create app directory if it doesn't exist
-    if (system(("if not exist \"" + appDir + "\" mkdir \"" + appDir + "\" > NUL 2>&1").c_str()) != 0)
+    if (mkdir(appDir.c_str(), 0755) != 0 && errno != EEXIST)
     {
         cerr << "Error: Unable to create application directory." << endl;
-        spdlog::get("file_logger")->error("Unable to create application directory.");
-        return 1;
-    }
-
-    tempDir = appDir + string("\\temp");
-
-    // Create temp directory if it doesn't exist
-    if (system(("if not exist \"" + tempDir + "\" mkdir \"" + tempDir + "\" > NUL 2>&1").c_str()) != 0)
-    {
-        cerr << "Error: Unable to create temporary directory." << endl;
-        spdlog::get("file_logger")->error("Unable to create temporary directory.");
         return 1;
     }
-#else
-    appDir = getenv("HOME") + string("/.DynamoDB-Table-Migration-Tool");
-    tempDir = appDir + string("/temp");
-#endif
 
     // Initialize logger
     try
@@ -100,8 +149,32 @@ int main(int argc, char *argv[])
             cout << "Options:" << endl;
             cout << "  -h, --help         Show this help message and exit." << endl;
             cout << "  -p, --path         Specify the path to JSON directory." << endl;
+            cout << "      --recursive    Also load definitions from subdirectories of the path." << endl;
             cout << "  -f, --force        Force re-creation of existing tables." << endl;
             cout << "  -d, --debug        Enable debug logging." << endl;
+            cout << "  -j, --jobs N       Process up to N tables concurrently (default: 1)." << endl;
+            cout << "  -e, --endpoint-url URL" << endl;
+            cout << "                     Send requests to URL. http:// endpoints use the built-in client," << endl;
+            cout << "                     anything else is passed to the AWS CLI." << endl;
+            cout << "  -c, --max-connections N" << endl;
+            cout << "                     Limit in-flight requests per endpoint for the built-in client (default: 64)." << endl;
+            cout << "  -w, --wait-active  Wait for each created table to become ACTIVE." << endl;
+            cout << "      --wait-timeout SECONDS" << endl;
+            cout << "                     Give up waiting for a table to be deleted or become ACTIVE (default: 300)." << endl;
+            cout << "      --max-pending-tables N" << endl;
+            cout << "                     Keep at most N tables in CREATING or DELETING state (default: no limit)." << endl;
+            cout << "      --keep-going   Create the valid tables even if some definitions are invalid." << endl;
+            cout << "      --no-cache     Check every file, even if it is unchanged since it was last applied." << endl;
+            cout << "      --tenants LIST Expand templates ({{tenant}} in TableName) once per tenant." << endl;
+            cout << "                     LIST is comma-separated, or @FILE with one tenant per line." << endl;
+            cout << "      --shard I/N    Only handle the tables of shard I out of N, assigned by a hash of TableName." << endl;
+            cout << "      --list-shards  Show how the tables spread over the N shards of --shard, then exit." << endl;
+            cout << "      --watch        Keep running and apply definition files again when they change." << endl;
+            cout << "      --include PATTERN" << endl;
+            cout << "                     Only handle tables whose TableName, or file path if PATTERN has a /," << endl;
+            cout << "                     matches. PATTERN is a glob, or a regular expression after re:." << endl;
+            cout << "      --exclude PATTERN" << endl;
+            cout << "                     Skip tables that match PATTERN, as for --include." << endl;
             return 0;
 
         case 'p':
@@ -116,6 +189,122 @@ int main(int argc, char *argv[])
             debug = true;
             break;
 
+        case 'j':
+        {
+            char *end = nullptr;
+            jobs = strtoul(optarg, &end, 10);
+            if (end == optarg || *end != '\0' || jobs == 0)
+            {
+                cerr << "Error: --jobs expects a positive number." << endl;
+                return 1;
+            }
+            break;
+        }
+
+        case 'e':
+            endpointUrl = optarg;
+            break;
+
+        case 'c':
+        {
+            char *end = nullptr;
+            unsigned long maxConnections = strtoul(optarg, &end, 10);
+            if (end == optarg || *end != '\0' || maxConnections == 0)
+            {
+                cerr << "Error: --max-connections expects a positive number." << endl;
+                return 1;
+            }
+            setMaxConnectionsPerEndpoint(maxConnections);
+            break;
+        }
+
+        case 'w':
+            waitForActive = true;
+            break;
+
+        case OPT_WAIT_TIMEOUT:
+        {
+            char *end = nullptr;
+            unsigned long seconds = strtoul(optarg, &end, 10);
+            if (end == optarg || *end != '\0' || seconds == 0)
+            {
+                cerr << "Error: --wait-timeout expects a positive number of seconds." << endl;
+                return 1;
+            }
+            tableWaitOptions.timeout = chrono::seconds(seconds);
+            break;
+        }
+
+        case OPT_MAX_PENDING_TABLES:
+        {
+            char *end = nullptr;
+            maxPendingTables = strtoul(optarg, &end, 10);
+            if (end == optarg || *end != '\0')
+            {
+                cerr << "Error: --max-pending-tables expects a number." << endl;
+                return 1;
+            }
+            break;
+        }
+
+        case OPT_KEEP_GOING:
+            keepGoing = true;
+            break;
+
+        case OPT_NO_CACHE:
+            useCache = false;
+            break;
+
+        case OPT_RECURSIVE:
+            recursive = true;
+            break;
+
+        case OPT_SHARD:
+        {
+            string shardError;
+            if (!parseShardSpec(optarg, shard, shardError))
+            {
+                cerr << "Error: " << shardError << "." << endl;
+                return 1;
+            }
+            break;
+        }
+
+        case OPT_LIST_SHARDS:
+            listShardsOnly = true;
+            break;
+
+        case OPT_WATCH:
+#ifndef __linux__
+            cerr << "Error: --watch needs inotify, which is only available on Linux." << endl;
+            return 1;
+#endif
+            watch = true;
+            break;
+
+        case OPT_INCLUDE:
+        case OPT_EXCLUDE:
+        {
+            string filterError;
+            if (!filter.add(optarg, opt == OPT_INCLUDE, filterError))
+            {
+                cerr << "Error: " << filterError << "." << endl;
+                return 1;
+            }
+            break;
+        }
+
+        case OPT_TENANTS:
+        {
+            string tenantError;
+            if (!loadTenantList(optarg, tenants, tenantError))
+            {
+                cerr << "Error: " << tenantError << "." << endl;
+                return 1;
+            }
+            break;
+        }
+
         default:
             cerr << "Usage: " << argv[0] << " [OPTIONS]" << endl;
             return 1;
@@ -132,6 +321,12 @@ int main(int argc, char *argv[])
         return 1;
     }
 
+    if (listShardsOnly && !shard.enabled())
+    {
+        cerr << "Error: --list-shards needs --shard I/N to know the number of shards." << endl;
+        return 1;
+    }
+
     // Handle case where path is "./" or "."
     if (jsonDir == "./" || jsonDir == ".")
     {
@@ -142,123 +337,230 @@ int main(int argc, char *argv[])
         }
     }
 
-    // Check if path is valid
-    if (!canAccessDynamoDB())
+    cout << "Loading JSON files from directory: " << jsonDir << endl;
+    spdlog::get("file_logger")->info("Loading JSON files from directory: {}", jsonDir);
+
+    // Started before the scan, so edits made during the first run aren't missed
+    DefinitionWatcher watcher;
+    string watchError;
+    if (watch && !listShardsOnly && !watcher.start(jsonDir, recursive, watchError))
     {
-        cerr << "Error: Unable to access DynamoDB." << endl;
-        spdlog::get("file_logger")->error("Unable to access DynamoDB.");
+        spdlog::get("file_logger")->error(watchError);
+        cerr << "Error: " << watchError << endl;
         return 1;
     }
 
-    string awsCommandBase = "aws dynamodb create-table --cli-input-json file://";
+    // Files are read while editors rewrite them, which a mapping doesn't survive
+    if (watch)
+        MappedFile::allowMapping(false);
 
-    cout << "Loading JSON files from directory: " << jsonDir << endl;
-    spdlog::get("file_logger")->info("Loading JSON files from directory: {}", jsonDir);
-    string tmpErrorFile = tempDir + "\\error.log"; // Temporary file to capture error messages
-    cout << "Temporary error file: " << tmpErrorFile << endl;
-    spdlog::get("file_logger")->info("Temporary error file: {}", tmpErrorFile);
-
-    DIR *dir;
-    struct dirent *ent;
-    if ((dir = opendir(jsonDir.c_str())) != nullptr)
+    // The scan runs in the background and feeds files to the checks as it finds them
+    size_t threads = thread::hardware_concurrency();
+    DefinitionScanner scanner;
+    string scanError;
+    if (!scanner.start(jsonDir, recursive, threads, scanError))
     {
+        spdlog::get("file_logger")->error(scanError);
+        cerr << "Error: " << scanError << endl;
+        return EXIT_FAILURE;
+    }
 
-        cout << endl
-             << "Creating tables..." << endl;
-        spdlog::get("file_logger")->info("Creating tables...");
+    // Dry run: only the table names are read
+    if (listShardsOnly)
+    {
+        listShards(jsonDir, scanner, tenants, filter, shard.count);
+        return 0;
+    }
 
-        while ((ent = readdir(dir)) != nullptr)
+    // Files that still hold what was last applied to this endpoint aren't
+    // read at all. Templates applied for another tenant list, or another
+    // shard, or other table name patterns, didn't create the same tables,
+    // so all of them are part of the key. Path patterns skip whole files
+    // and don't change what a file creates. --force re-creates every table,
+    // so it neither reads nor writes the cache file; under --watch the
+    // cache still lives in memory to drop saves that didn't change a file.
+    string cacheKey = (endpointUrl.empty() ? "default" : endpointUrl) + "|" + loadAwsRegion() + "|" +
+                      (getenv("AWS_PROFILE") ? getenv("AWS_PROFILE") : "");
+    for (const auto &tenant : tenants)
+        cacheKey += "|" + tenant;
+    if (shard.enabled())
+        cacheKey += "|shard " + to_string(shard.index) + "/" + to_string(shard.count);
+    cacheKey += filter.tableNameKey();
+    DefinitionCache cache(DefinitionCache::pathFor(appDir, cacheKey));
+    bool persistCache = useCache && !force;
+    bool trackVersions = persistCache || (useCache && watch);
+    if (persistCache)
+        cache.load();
+
+    // With --shard or table name patterns, the definitions this run doesn't
+    // handle are dropped once their TableName is read, before they are parsed
+    DefinitionSelector selected;
+    if (shard.enabled() || filter.filtersTableNames())
+        selected = [&](const string &tableName, const string &label)
+        { return filter.acceptsTableName(tableName) && ownsDefinition(shard, tableName, label); };
+
+    // Check every definition locally, in parallel, before any remote call
+    vector<CachedFile> cachedFiles;
+    size_t filteredFiles = 0;
+    PreflightResult preflight = preflightDefinitions(
+        jsonDir, [&](string &filename)
         {
-            string filename = ent->d_name;
-            if (filename.size() > 5 && filename.substr(filename.size() - 5) == ".json")
+            while (scanner.next(filename))
             {
-                string jsonFile = jsonDir + "/" + filename;
-                DEBUG_LOG("Processing JSON file: " << jsonFile);
-                spdlog::get("file_logger")->debug("Processing JSON file: {}", jsonFile);
-                string tableName = getTableNameFromJson(jsonFile);
-
-                cout << "  Processing " << tableName << " table..." << endl;
-                spdlog::get("file_logger")->info("Processing {} table...", tableName);
-
-                if (!tableName.empty())
-                {
-                    // Check if table already exists, moved here so it only runs once per file
-                    bool tableAlreadyExists = tableExists(tableName);
-
-                    if (tableAlreadyExists && !force)
-                    {
-                        cout << "  - Skipping " << filename << ", table already exists." << endl;
-                        spdlog::get("file_logger")->info("Skipping {}, table already exists.", filename);
-                    }
-                    else
-                    {
-                        // Delete if force flag set and table exists
-                        if (force && tableAlreadyExists)
-                        {
-                            string deleteCommand = "aws dynamodb delete-table --table-name " + tableName + " > NUL 2>&1";
-                            int deleteResult = system(deleteCommand.c_str());
-                            if (deleteResult != 0)
-                            {
-                                cerr << "  - Error deleting table for " << filename << "." << endl;
-                                spdlog::get("file_logger")->error("Error deleting table for {}.", filename);
-                            }
-                            else
-                            {
-                                cout << "  + Deleted table for " << filename << "." << endl;
-                                spdlog::get("file_logger")->info("Deleted table for {}.", filename);
-                            }
-                        }
-
-                        // Create table
-                        string command = awsCommandBase + jsonFile + " > NUL 2>" + tmpErrorFile;
-                        int result = system(command.c_str());
-                        if (result != 0)
-                        {
-                            ifstream errorStream(tmpErrorFile);
-                            if (errorStream.is_open())
-                            {
-                                string line;
-                                cerr << "  - Error creating table for " << filename << ":\n";
-                                spdlog::get("file_logger")->error("Error creating table for {}", filename);
-                                while (getline(errorStream, line))
-                                {
-                                    cerr << "    " << line << "\n";
-                                }
-                                errorStream.close();
-                            }
-                            else
-                            {
-                                cerr << "  - Error creating table for " << filename << ", and couldn't read the error log." << endl;
-                                spdlog::get("file_logger")->error("Error creating table for {}, and couldn't read the error log.", filename);
-                            }
-                            remove(tmpErrorFile.c_str()); // Delete the temporary error file
-                        }
-                        else
-                        {
-                            cout << "  + Created table for " << filename << "." << endl;
-                            spdlog::get("file_logger")->info("Created table for {}.", filename);
-                            remove(tmpErrorFile.c_str()); // Delete the temporary error file if it exists
-                        }
-                    }
-                }
-                else
+                // Path patterns are decided on the name, before the file is touched
+                if (!filter.acceptsPath(filename))
                 {
-                    cerr << "  - Could not get table name from " << filename << "." << endl;
+                    ++filteredFiles;
+                    continue;
                 }
+                CachedFile cached;
+                if (!useCache || !cache.isUnchanged(jsonDir + "/" + filename, cached.tables))
+                    return true;
+                cached.filename = filename;
+                cachedFiles.push_back(std::move(cached));
+            }
+            return false; },
+        tenants, selected, trackVersions, threads);
+    sort(cachedFiles.begin(), cachedFiles.end(), [](const CachedFile &a, const CachedFile &b)
+         { return a.filename < b.filename; });
+    DEBUG_LOG("Scanned " << scanner.directoryCount() << " director" << (scanner.directoryCount() == 1 ? "y" : "ies") << ".");
+
+    // Files that weren't read still create their tables, as the cache recorded
+    TableOwners owners;
+    for (const auto &cached : cachedFiles)
+        for (const auto &table : cached.tables)
+            owners.emplace(table, TableOwner{cached.filename, cached.filename});
+    checkDuplicateTables(jsonDir, preflight, owners);
+    if (!acceptPreflight(preflight, keepGoing))
+        return 1;
+
+    string clientError;
+    if (!initDynamoDBClient(endpointUrl, clientError))
+    {
+        cerr << "Error: " << clientError << endl;
+        spdlog::get("file_logger")->error(clientError);
+        return 1;
+    }
+    cout << "Using DynamoDB via " << dynamoClient().description() << endl;
+    spdlog::get("file_logger")->info("Using DynamoDB via {}", dynamoClient().description());
+
+    // Check if path is valid
+    if (!canAccessDynamoDB())
+    {
+        cerr << "Error: Unable to access DynamoDB." << endl;
+        spdlog::get("file_logger")->error("Unable to access DynamoDB.");
+        return 1;
+    }
+
+    // A cached table that is gone (e.g. after DynamoDB Local restarted) needs its file applied again
+    vector<string> recheckFiles;
+    for (const auto &cached : cachedFiles)
+    {
+        for (const auto &table : cached.tables)
+        {
+            bool exists = false;
+            if (!lookupTableSnapshot(table, exists) || !exists)
+            {
+                recheckFiles.push_back(cached.filename);
+                break;
             }
         }
+    }
+    if (!recheckFiles.empty())
+    {
+        PreflightResult recheck = preflightDefinitions(jsonDir, recheckFiles, tenants, selected, trackVersions, threads);
+        checkDuplicateTables(jsonDir, recheck, owners);
+        if (!acceptPreflight(recheck, keepGoing))
+            return 1;
+        preflight.unselected += recheck.unselected;
+        preflight.sources.insert(preflight.sources.end(), recheck.sources.begin(), recheck.sources.end());
+        stable_sort(preflight.sources.begin(), preflight.sources.end(), [](const DefinitionSource &a, const DefinitionSource &b)
+                    { return a.filename < b.filename; });
+    }
 
-        closedir(dir);
+    size_t unchangedFiles = cachedFiles.size() - recheckFiles.size();
+    if (unchangedFiles > 0)
+    {
+        cout << unchangedFiles << " definition file(s) unchanged since the last run, skipped." << endl;
+        spdlog::get("file_logger")->info("{} definition file(s) unchanged since the last run, skipped.", unchangedFiles);
+    }
+
+    if (filter.filtersPaths() || filter.filtersTableNames())
+    {
+        cout << "Filters skipped " << filteredFiles << " file(s) by path and " << preflight.unselected << " definition(s) by table name"
+             << (shard.enabled() ? " or shard." : ".") << endl;
+        spdlog::get("file_logger")->info("Filters skipped {} file(s) by path and {} definition(s) by table name{}", filteredFiles,
+                                         preflight.unselected, shard.enabled() ? " or shard." : ".");
+    }
+    else if (shard.enabled())
+    {
+        cout << "Shard " << shard.index << "/" << shard.count << ": " << preflight.unselected << " definition(s) left to other shards."
+             << endl;
+        spdlog::get("file_logger")->info("Shard {}/{}: {} definition(s) left to other shards.", shard.index, shard.count, preflight.unselected);
+    }
+
+    // Tables advance concurrently on one event loop; --jobs bounds how many are in flight.
+    // The loop, connections and table snapshot stay alive between --watch cycles.
+    EventLoop loop;
+    auto applyDefinitions = [&](const vector<DefinitionSource> &sources)
+    {
+        cout << endl
+             << "Creating tables..." << endl;
+        spdlog::get("file_logger")->info("Creating tables with up to {} in flight...", jobs);
+
+        vector<TableResult> results = processTableFiles(loop, jsonDir, sources, jobs, maxPendingTables);
 
         cout << endl
              << "Finished creating tables." << endl;
         spdlog::get("file_logger")->info("Finished creating tables.");
-    }
-    else
+
+        printSummary(results);
+        logConnectionPoolStats();
+
+        if (trackVersions)
+            recordAppliedFiles(cache, jsonDir, sources, results, !force);
+        if (persistCache && !cache.save())
+            cerr << "Warning: Could not update the definition cache." << endl;
+    };
+    applyDefinitions(preflight.sources);
+
+    if (watch)
     {
-        spdlog::get("file_logger")->error("Could not open directory: {}", jsonDir);
-        perror("Could not open directory");
-        return EXIT_FAILURE;
+        cout << endl
+             << "Watching " << jsonDir << " for changes. Press Ctrl+C to stop." << endl;
+        spdlog::get("file_logger")->info("Watching {} for changes.", jsonDir);
+
+        vector<string> changed;
+        while (watcher.waitForChanges(watchDebounce, changed, watchError))
+        {
+            // A save that didn't change the bytes is caught by the cache
+            vector<string> changedFiles;
+            for (const auto &filename : changed)
+            {
+                vector<string> tables;
+                if (!filter.acceptsPath(filename))
+                    continue;
+                if (!useCache || !cache.isUnchanged(jsonDir + "/" + filename, tables))
+                    changedFiles.push_back(filename);
+            }
+            if (changedFiles.empty())
+                continue;
+
+            cout << endl
+                 << changedFiles.size() << " definition file(s) changed." << endl;
+            spdlog::get("file_logger")->info("{} definition file(s) changed.", changedFiles.size());
+
+            // An invalid edit is reported and waits for the next save
+            PreflightResult update = preflightDefinitions(jsonDir, changedFiles, tenants, selected, trackVersions, threads);
+            checkDuplicateTables(jsonDir, update, owners);
+            if (!acceptPreflight(update, keepGoing))
+                continue;
+            applyDefinitions(update.sources);
+        }
+
+        spdlog::get("file_logger")->error(watchError);
+        cerr << "Error: " << watchError << endl;
+        return 1;
     }
 
     spdlog::get("file_logger")->debug("Program finished.");
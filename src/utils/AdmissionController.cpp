@@ -0,0 +1,77 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#include <algorithm>
+#include "AdmissionController.h"
+
+AdmissionTicket &AdmissionTicket::operator=(AdmissionTicket &&other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        controller = exchange(other.controller, nullptr);
+    }
+    return *this;
+}
+
+// Give the slot back early
+void AdmissionTicket::release()
+{
+    if (controller != nullptr)
+    {
+        controller->release();
+        controller = nullptr;
+    }
+}
+
+AdmissionController::AdmissionController(EventLoop &loop, size_t limit) : loop(loop), limit(limit)
+{
+}
+
+// Take a slot if one is free; otherwise the caller queues
+bool AdmissionController::tryAdmit()
+{
+    if (limit != 0 && active >= limit)
+    {
+        ++waits;
+        return false;
+    }
+
+    ++active;
+    peak = max(peak, active);
+    return true;
+}
+
+void AdmissionController::release()
+{
+    --active;
+    admitWaiting();
+}
+
+// Change the limit at runtime
+void AdmissionController::setLimit(size_t newLimit)
+{
+    limit = newLimit;
+    admitWaiting();
+}
+
+// Hand free slots to waiting tables in arrival order. Resumption is posted so
+// a releasing coroutine never runs another table's workflow on its own stack.
+void AdmissionController::admitWaiting()
+{
+    while (!waiters.empty() && (limit == 0 || active < limit))
+    {
+        coroutine_handle<> next = waiters.front();
+        waiters.pop_front();
+
+        ++active;
+        peak = max(peak, active);
+        loop.post([next]
+                  { next.resume(); });
+    }
+}
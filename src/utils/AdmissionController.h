@@ -0,0 +1,91 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#ifndef ADMISSION_CONTROLLER_H
+#define ADMISSION_CONTROLLER_H
+
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <utility>
+#include "EventLoop.h"
+
+using namespace std;
+
+class AdmissionController;
+
+// One admitted control-plane operation; gives its slot back when destroyed
+class AdmissionTicket
+{
+public:
+    AdmissionTicket() = default;
+    explicit AdmissionTicket(AdmissionController *controller) : controller(controller) {}
+    AdmissionTicket(AdmissionTicket &&other) noexcept : controller(exchange(other.controller, nullptr)) {}
+    AdmissionTicket &operator=(AdmissionTicket &&other) noexcept;
+    AdmissionTicket(const AdmissionTicket &) = delete;
+    AdmissionTicket &operator=(const AdmissionTicket &) = delete;
+    ~AdmissionTicket() { release(); }
+
+    // Give the slot back early
+    void release();
+
+private:
+    AdmissionController *controller = nullptr;
+};
+
+// Limits how many tables this run has in CREATING or DELETING state at once.
+// DynamoDB rejects control-plane calls past its account limit with
+// LimitExceededException, so tables wait here for a slot instead; a slot is
+// handed to the next waiting table as soon as one frees. Loop-thread only.
+class AdmissionController
+{
+public:
+    // limit 0 admits everything immediately
+    AdmissionController(EventLoop &loop, size_t limit);
+
+    class Awaiter
+    {
+    public:
+        explicit Awaiter(AdmissionController &controller) : controller(controller) {}
+
+        bool await_ready() { return controller.tryAdmit(); }
+        void await_suspend(coroutine_handle<> waiting) { controller.waiters.push_back(waiting); }
+        AdmissionTicket await_resume() { return AdmissionTicket(&controller); }
+
+    private:
+        AdmissionController &controller;
+    };
+
+    // AdmissionTicket ticket = co_await controller.admit();
+    Awaiter admit() { return Awaiter(*this); }
+
+    // Change the limit at runtime; waiting tables are admitted if it grew
+    void setLimit(size_t newLimit);
+
+    bool enabled() const { return limit != 0; }
+    size_t currentLimit() const { return limit; }
+    size_t inFlight() const { return active; }
+    size_t peakInFlight() const { return peak; }
+    size_t waitCount() const { return waits; }
+
+private:
+    friend class AdmissionTicket;
+
+    bool tryAdmit();
+    void release();
+    void admitWaiting();
+
+    EventLoop &loop;
+    size_t limit;
+    size_t active = 0;
+    size_t peak = 0;
+    size_t waits = 0;
+    deque<coroutine_handle<>> waiters;
+};
+
+#endif
@@ -0,0 +1,60 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#include <algorithm>
+#include "AimdController.h"
+#include "TableMigrationTool.h"
+
+namespace
+{
+    // Errors from requests sent before a decrease arrive shortly after it;
+    // don't let them halve the limit again
+    const auto decreaseCooldown = chrono::seconds(1);
+}
+
+AimdController::AimdController(AdmissionController &admission, size_t ceiling)
+    : admission(admission), ceiling(max<size_t>(ceiling, 1))
+{
+}
+
+void AimdController::onSuccess()
+{
+    if (!admission.enabled())
+        return;
+
+    size_t limit = admission.currentLimit();
+    if (limit >= ceiling)
+        return;
+
+    // Additive increase: one more slot per full window of successes
+    if (++successesSinceChange >= limit)
+    {
+        successesSinceChange = 0;
+        ++increaseCount;
+        admission.setLimit(limit + 1);
+        DEBUG_LOG("AIMD: concurrency limit raised to " << limit + 1 << ".");
+    }
+}
+
+void AimdController::onCongestion(const string &reason)
+{
+    auto now = chrono::steady_clock::now();
+    if (decreaseCount > 0 && now - lastDecrease < decreaseCooldown)
+        return;
+
+    // Multiplicative decrease from the current limit, or from the observed
+    // concurrency when no limit was set yet
+    size_t current = admission.enabled() ? admission.currentLimit() : min(ceiling, admission.inFlight());
+    size_t limit = max<size_t>(current / 2, 1);
+
+    lastDecrease = now;
+    successesSinceChange = 0;
+    ++decreaseCount;
+    admission.setLimit(limit);
+    DEBUG_LOG("AIMD: concurrency limit lowered to " << limit << " after " << reason << ".");
+}
@@ -0,0 +1,44 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#ifndef AIMD_CONTROLLER_H
+#define AIMD_CONTROLLER_H
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include "AdmissionController.h"
+
+using namespace std;
+
+// Additive-increase/multiplicative-decrease tuning of the admission limit.
+// Throttling and limit errors halve the limit (at most once per cooldown, so
+// one burst of errors counts once); every `limit` successes raise it by one,
+// up to the ceiling. Until the first congestion signal an unlimited
+// controller stays unlimited. Loop-thread only.
+class AimdController
+{
+public:
+    AimdController(AdmissionController &admission, size_t ceiling);
+
+    void onSuccess();
+    void onCongestion(const string &reason);
+
+    size_t decreases() const { return decreaseCount; }
+    size_t increases() const { return increaseCount; }
+
+private:
+    AdmissionController &admission;
+    size_t ceiling;
+    size_t successesSinceChange = 0;
+    size_t decreaseCount = 0;
+    size_t increaseCount = 0;
+    chrono::steady_clock::time_point lastDecrease;
+};
+
+#endif
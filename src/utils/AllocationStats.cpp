@@ -0,0 +1,121 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#include <new>
+#include "AllocationStats.h"
+#include "TableMigrationTool.h"
+#include "spdlog/spdlog.h"
+
+#ifdef COUNT_ALLOCATIONS
+
+namespace
+{
+    atomic<size_t> allocationCount{0};
+    atomic<size_t> allocationBytes{0};
+
+    void *countedNew(size_t size)
+    {
+        countAllocation(size);
+        if (void *ptr = std::malloc(size ? size : 1))
+            return ptr;
+        throw bad_alloc();
+    }
+}
+
+void countAllocation(size_t size)
+{
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    allocationBytes.fetch_add(size, memory_order_relaxed);
+}
+
+AllocationStats allocationStats()
+{
+    AllocationStats stats;
+    stats.allocations = allocationCount.load(memory_order_relaxed);
+    stats.bytes = allocationBytes.load(memory_order_relaxed);
+    return stats;
+}
+
+// Log the allocations made since `since`, e.g. while processing the files
+void logAllocationStats(const AllocationStats &since, const string &what)
+{
+    AllocationStats now = allocationStats();
+    size_t allocations = now.allocations - since.allocations;
+    size_t bytes = now.bytes - since.bytes;
+
+    DEBUG_LOG("Allocations: " << allocations << " heap allocation(s), " << bytes << " byte(s) " << what << ".");
+    auto fileLogger = spdlog::get("file_logger");
+    if (fileLogger)
+        fileLogger->debug("Allocations: {} heap allocation(s), {} byte(s) {}.", allocations, bytes, what);
+}
+
+// Replaceable global allocation functions, counted
+void *operator new(size_t size)
+{
+    return countedNew(size);
+}
+
+void *operator new[](size_t size)
+{
+    return countedNew(size);
+}
+
+void *operator new(size_t size, const nothrow_t &) noexcept
+{
+    countAllocation(size);
+    return std::malloc(size ? size : 1);
+}
+
+void *operator new[](size_t size, const nothrow_t &) noexcept
+{
+    countAllocation(size);
+    return std::malloc(size ? size : 1);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, const nothrow_t &) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, const nothrow_t &) noexcept
+{
+    std::free(ptr);
+}
+
+#else
+
+AllocationStats allocationStats()
+{
+    return {};
+}
+
+void logAllocationStats(const AllocationStats &, const string &)
+{
+}
+
+#endif
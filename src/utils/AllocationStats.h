@@ -0,0 +1,72 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#ifndef ALLOCATION_STATS_H
+#define ALLOCATION_STATS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+
+using namespace std;
+
+// Process-wide heap allocation counters, built only with the
+// COUNT_ALLOCATIONS CMake option. operator new is replaced to count C++
+// allocations; rapidjson's arenas get their chunks from CountingAllocator,
+// which counts into the same totals. Without the option nothing is counted
+// and nothing is logged.
+struct AllocationStats
+{
+    size_t allocations = 0;
+    size_t bytes = 0;
+};
+
+AllocationStats allocationStats();
+
+#ifdef COUNT_ALLOCATIONS
+void countAllocation(size_t size);
+#else
+inline void countAllocation(size_t) {}
+#endif
+
+// Log the allocations made since `since`, e.g. while processing the files
+void logAllocationStats(const AllocationStats &since, const string &what);
+
+// rapidjson base allocator (the CrtAllocator interface) that counts mallocs
+class CountingAllocator
+{
+public:
+    static const bool kNeedFree = true;
+
+    void *Malloc(size_t size)
+    {
+        if (size == 0)
+            return nullptr;
+        countAllocation(size);
+        return std::malloc(size);
+    }
+
+    void *Realloc(void *originalPtr, size_t, size_t newSize)
+    {
+        if (newSize == 0)
+        {
+            std::free(originalPtr);
+            return nullptr;
+        }
+        countAllocation(newSize);
+        return std::realloc(originalPtr, newSize);
+    }
+
+    static void Free(void *ptr) noexcept { std::free(ptr); }
+
+    bool operator==(const CountingAllocator &) const noexcept { return true; }
+    bool operator!=(const CountingAllocator &) const noexcept { return false; }
+};
+
+#endif
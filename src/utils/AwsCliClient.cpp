@@ -0,0 +1,95 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#include "AwsCliClient.h"
+#include "ProcessExecutor.h"
+
+namespace
+{
+    // How botocore reports a request that got no answer
+    const char *const noResponseErrors[] = {
+        "Could not connect to the endpoint URL",
+        "Connect timeout on endpoint URL",
+        "Read timeout on endpoint URL",
+        "Connection was closed before we received a valid response",
+    };
+}
+
+AwsCliClient::AwsCliClient(const string &endpointUrl) : endpointUrl(endpointUrl)
+{
+}
+
+// Run the matching "aws dynamodb" subcommand and translate its output
+void AwsCliClient::submit(EventLoop &loop, const DynamoRequest &request, DynamoCallback done)
+{
+    vector<string> command = {"aws", "dynamodb"};
+    string input;
+    switch (request.operation)
+    {
+    case DynamoOperation::ListTables:
+        command.insert(command.end(), {"list-tables", "--max-items", "1000"});
+        if (!request.startToken.empty())
+            command.insert(command.end(), {"--starting-token", request.startToken});
+        break;
+    case DynamoOperation::DescribeTable:
+        command.insert(command.end(), {"describe-table", "--table-name", request.tableName});
+        break;
+    case DynamoOperation::CreateTable:
+        // A definition can be far larger than one argument may be (128 KiB
+        // on Linux), so it goes through stdin
+        input = request.requestJson;
+        command.insert(command.end(), {"create-table", "--cli-input-json", "file:///dev/stdin"});
+        break;
+    case DynamoOperation::DeleteTable:
+        command.insert(command.end(), {"delete-table", "--table-name", request.tableName});
+        break;
+    }
+
+    command.insert(command.end(), {"--output", "json"});
+    if (!endpointUrl.empty())
+        command.insert(command.end(), {"--endpoint-url", endpointUrl});
+
+    DynamoOperation operation = request.operation;
+    runCommandAsync(loop, command, [operation, done](CommandResult commandResult)
+                    {
+                        DynamoResult result;
+                        result.success = commandResult.ok();
+                        if (result.success)
+                        {
+                            result.body = std::move(commandResult.output);
+                            decodeDynamoResult(operation, "NextToken", result);
+                            done(std::move(result));
+                            return;
+                        }
+
+                        // The CLI reports service errors as "An error occurred (Type) when calling ..."
+                        result.message = commandResult.errorOutput;
+                        size_t start = result.message.find("An error occurred (");
+                        if (start != string::npos)
+                        {
+                            start += 19;
+                            size_t end = result.message.find(')', start);
+                            if (end != string::npos)
+                                result.errorType = result.message.substr(start, end - start);
+
+                            // A response without an error type is reported by its status, e.g. "(503)"
+                            if (!result.errorType.empty() && result.errorType.find_first_not_of("0123456789") == string::npos)
+                            {
+                                result.httpStatus = stoi(result.errorType);
+                                result.errorType.clear();
+                            }
+                        }
+                        for (const char *text : noResponseErrors)
+                            result.noResponse = result.noResponse || result.message.find(text) != string::npos;
+                        done(std::move(result)); }, std::move(input));
+}
+
+string AwsCliClient::description() const
+{
+    return endpointUrl.empty() ? "AWS CLI" : "AWS CLI (" + endpointUrl + ")";
+}
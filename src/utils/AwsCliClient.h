@@ -0,0 +1,27 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#ifndef AWS_CLI_CLIENT_H
+#define AWS_CLI_CLIENT_H
+
+#include "DynamoDBClient.h"
+
+// DynamoDB backend that runs "aws dynamodb ..." for every call
+class AwsCliClient : public DynamoDBClient
+{
+public:
+    explicit AwsCliClient(const string &endpointUrl);
+
+    void submit(EventLoop &loop, const DynamoRequest &request, DynamoCallback done) override;
+    string description() const override;
+
+private:
+    string endpointUrl;
+};
+
+#endif
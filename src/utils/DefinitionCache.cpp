@@ -0,0 +1,199 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include "DefinitionCache.h"
+#include "MappedFile.h"
+#include "SigV4.h"
+#include "TableMigrationTool.h"
+
+namespace
+{
+    // Hex SHA-256 of a file's bytes, or empty if it can't be read
+    string hashFile(const string &path)
+    {
+        MappedFile file;
+        string error;
+        if (!file.open(path, error))
+            return "";
+        return toHex(sha256(file.data(), file.size()));
+    }
+
+    vector<string> splitList(const string &text)
+    {
+        vector<string> items;
+        stringstream stream(text);
+        string item;
+        while (getline(stream, item, ','))
+        {
+            if (!item.empty())
+                items.push_back(item);
+        }
+        return items;
+    }
+}
+
+// The cache file for an endpoint (and region/profile) under appDir
+string DefinitionCache::pathFor(const string &appDir, const string &endpointKey)
+{
+    return appDir + "/applied-" + toHex(sha256(endpointKey)).substr(0, 16) + ".tsv";
+}
+
+DefinitionCache::DefinitionCache(const string &cacheFile) : cacheFile(cacheFile)
+{
+}
+
+// Read the cache file; a missing or unreadable file is an empty cache
+void DefinitionCache::load()
+{
+    ifstream file(cacheFile);
+    string line;
+    while (getline(file, line))
+    {
+        // path, inode, size, mtime, hash, tables
+        vector<string> fields;
+        stringstream stream(line);
+        string field;
+        while (getline(stream, field, '\t'))
+            fields.push_back(field);
+        if (fields.size() != 6)
+            continue;
+
+        Entry entry;
+        entry.version.fingerprint.inode = strtoull(fields[1].c_str(), nullptr, 10);
+        entry.version.fingerprint.size = strtoull(fields[2].c_str(), nullptr, 10);
+        entry.version.fingerprint.mtimeNs = strtoll(fields[3].c_str(), nullptr, 10);
+        entry.version.hash = fields[4];
+        entry.tables = splitList(fields[5]);
+        entries[fields[0]] = std::move(entry);
+    }
+    DEBUG_LOG("Loaded " << entries.size() << " cached definition file(s) from " << cacheFile);
+}
+
+// Write the cache file if anything changed
+bool DefinitionCache::save()
+{
+    if (!dirty)
+        return true;
+
+    // Write a temporary file and rename it, so a crash never leaves half a cache
+    string temporary = cacheFile + ".tmp";
+    {
+        ofstream file(temporary, ios::trunc);
+        if (!file.is_open())
+            return false;
+
+        for (const auto &item : entries)
+        {
+            const Entry &entry = item.second;
+            const FileFingerprint &fingerprint = entry.version.fingerprint;
+            file << item.first << '\t' << fingerprint.inode << '\t' << fingerprint.size << '\t' << fingerprint.mtimeNs << '\t'
+                 << entry.version.hash << '\t';
+            for (size_t i = 0; i < entry.tables.size(); ++i)
+                file << (i ? "," : "") << entry.tables[i];
+            file << '\n';
+        }
+        if (!file.good())
+            return false;
+    }
+
+    if (rename(temporary.c_str(), cacheFile.c_str()) != 0)
+        return false;
+    dirty = false;
+    return true;
+}
+
+// Whether path still holds what was last applied; fills its tables
+bool DefinitionCache::isUnchanged(const string &path, vector<string> &tables)
+{
+    auto entry = entries.find(path);
+    if (entry == entries.end())
+        return false;
+
+    FileFingerprint fingerprint;
+    if (!fingerprintFile(path, fingerprint))
+        return false;
+
+    // Touched, copied or checked out again: only the bytes can tell
+    FileVersion &version = entry->second.version;
+    if (!(fingerprint == version.fingerprint))
+    {
+        if (fingerprint.size != version.fingerprint.size || hashFile(path) != version.hash)
+            return false;
+
+        DEBUG_LOG("Definition file " << path << " has a new fingerprint but the same contents.");
+        version.fingerprint = fingerprint;
+        dirty = true;
+    }
+
+    tables = entry->second.tables;
+    return true;
+}
+
+// Remember version of path as applied, defining these tables
+void DefinitionCache::record(const string &path, const FileVersion &version, const vector<string> &tables)
+{
+    // The file format has no quoting
+    if (path.find_first_of("\t\n") != string::npos || version.hash.empty())
+        return;
+
+    Entry entry;
+    entry.version = version;
+    entry.tables = tables;
+    entries[path] = std::move(entry);
+    dirty = true;
+}
+
+// Drop path, e.g. after a failed apply
+void DefinitionCache::forget(const string &path)
+{
+    dirty = entries.erase(path) != 0 || dirty;
+}
+
+// Record the files whose every definition ended in an accepted outcome
+void recordAppliedFiles(DefinitionCache &cache, const string &jsonDir, const vector<DefinitionSource> &sources,
+                        const vector<TableResult> &results, bool recordSkipped)
+{
+    // Sources of one file are adjacent
+    size_t index = 0;
+    while (index < sources.size())
+    {
+        const string &filename = sources[index].filename;
+        vector<string> tables;
+        bool applied = true;
+        bool failed = false;
+        for (; index < sources.size() && sources[index].filename == filename; ++index)
+        {
+            const TableResult &result = results[index];
+            tables.push_back(result.tableName);
+            switch (result.outcome)
+            {
+            case TableOutcome::Created:
+            case TableOutcome::Recreated:
+                break;
+            case TableOutcome::Skipped:
+                applied = applied && recordSkipped;
+                break;
+            case TableOutcome::Failed:
+            case TableOutcome::InvalidDefinition:
+                applied = false;
+                failed = true;
+                break;
+            }
+        }
+
+        // Only what pre-flight read was applied, whatever is on disk now
+        const shared_ptr<FileVersion> &version = sources[index - 1].version;
+        if (failed)
+            cache.forget(jsonDir + "/" + filename);
+        else if (applied && version)
+            cache.record(jsonDir + "/" + filename, *version, tables);
+    }
+}
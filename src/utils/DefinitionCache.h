@@ -0,0 +1,75 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#ifndef DEFINITION_CACHE_H
+#define DEFINITION_CACHE_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "DefinitionSource.h"
+#include "FileVersion.h"
+#include "TableProcessor.h"
+
+using namespace std;
+
+// Remembers, per definition file, what was last applied to one endpoint:
+// the file's stat fingerprint, a SHA-256 of its bytes and the tables it
+// defines. A file whose fingerprint still matches is unchanged without
+// being read; one whose fingerprint changed is hashed, and is unchanged if
+// the bytes are. Stored as a tab-separated file under appDir.
+class DefinitionCache
+{
+public:
+    // The cache file for an endpoint (and region/profile) under appDir
+    static string pathFor(const string &appDir, const string &endpointKey);
+
+    explicit DefinitionCache(const string &cacheFile);
+
+    // Read the cache file; a missing or unreadable file is an empty cache
+    void load();
+
+    // Write the cache file if anything changed
+    bool save();
+
+    // Whether path still holds what was last applied; fills its tables
+    bool isUnchanged(const string &path, vector<string> &tables);
+
+    // Remember version of path as applied, defining these tables
+    void record(const string &path, const FileVersion &version, const vector<string> &tables);
+
+    // Drop path, e.g. after a failed apply
+    void forget(const string &path);
+
+private:
+    struct Entry
+    {
+        FileVersion version;
+        vector<string> tables;
+    };
+
+    string cacheFile;
+    unordered_map<string, Entry> entries;
+    bool dirty = false;
+};
+
+// A file left out of the run because it still holds what was last applied
+struct CachedFile
+{
+    string filename;
+    vector<string> tables;
+};
+
+// Record the files whose every definition ended in an accepted outcome
+// (Created/Recreated, plus Skipped when recordSkipped), as the version
+// pre-flight read; forget the files with a failed or invalid definition
+// and leave the rest as they were
+void recordAppliedFiles(DefinitionCache &cache, const string &jsonDir, const vector<DefinitionSource> &sources,
+                        const vector<TableResult> &results, bool recordSkipped);
+
+#endif
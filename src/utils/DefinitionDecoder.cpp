@@ -0,0 +1,332 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#include <array>
+#include <string_view>
+#include "DefinitionDecoder.h"
+
+using Field = DefinitionDecoder::Field;
+
+namespace
+{
+    struct FieldName
+    {
+        string_view name;
+        Field field;
+    };
+
+    // Every member name the decoder looks at, in any object
+    constexpr FieldName fieldNames[] = {
+        {"TableName", Field::TableName},
+        {"KeySchema", Field::KeySchema},
+        {"AttributeDefinitions", Field::AttributeDefinitions},
+        {"GlobalSecondaryIndexes", Field::GlobalSecondaryIndexes},
+        {"LocalSecondaryIndexes", Field::LocalSecondaryIndexes},
+        {"BillingMode", Field::BillingMode},
+        {"ProvisionedThroughput", Field::ProvisionedThroughput},
+        {"StreamSpecification", Field::StreamSpecification},
+        {"AttributeName", Field::AttributeName},
+        {"KeyType", Field::KeyType},
+        {"AttributeType", Field::AttributeType},
+        {"IndexName", Field::IndexName},
+        {"Projection", Field::Projection},
+        {"ProjectionType", Field::ProjectionType},
+        {"NonKeyAttributes", Field::NonKeyAttributes},
+        {"ReadCapacityUnits", Field::ReadCapacityUnits},
+        {"WriteCapacityUnits", Field::WriteCapacityUnits},
+        {"StreamEnabled", Field::StreamEnabled},
+        {"StreamViewType", Field::StreamViewType},
+    };
+    constexpr size_t fieldCount = sizeof(fieldNames) / sizeof(fieldNames[0]);
+
+    constexpr unsigned slotBits = 5;
+    constexpr size_t slotCount = size_t(1) << slotBits;
+    static_assert(fieldCount < slotCount, "Too many fields for the slot table");
+
+    // FNV-1a, then a seeded multiplicative step that takes the top bits
+    constexpr size_t slotOf(string_view name, uint32_t seed)
+    {
+        uint32_t hash = 2166136261u;
+        for (char c : name)
+            hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+        return ((hash ^ seed) * 2654435761u) >> (32 - slotBits);
+    }
+
+    // The first seed that puts every name in a slot of its own
+    constexpr uint32_t findSeed()
+    {
+        for (uint32_t seed = 1; seed < 100000; ++seed)
+        {
+            bool used[slotCount] = {};
+            bool collision = false;
+            for (const auto &entry : fieldNames)
+            {
+                size_t slot = slotOf(entry.name, seed);
+                collision = collision || used[slot];
+                used[slot] = true;
+            }
+            if (!collision)
+                return seed;
+        }
+        return 0;
+    }
+
+    constexpr uint32_t fieldSeed = findSeed();
+    static_assert(fieldSeed != 0, "No perfect hash seed for the field table");
+
+    // Slot -> index into fieldNames plus one; zero for an empty slot
+    constexpr array<uint8_t, slotCount> buildSlots()
+    {
+        array<uint8_t, slotCount> slots = {};
+        for (size_t i = 0; i < fieldCount; ++i)
+            slots[slotOf(fieldNames[i].name, fieldSeed)] = static_cast<uint8_t>(i + 1);
+        return slots;
+    }
+
+    constexpr array<uint8_t, slotCount> fieldSlots = buildSlots();
+}
+
+// Map a member name to its field, None if the tool doesn't model it
+Field DefinitionDecoder::lookupField(const char *name, size_t length)
+{
+    string_view key(name, length);
+    uint8_t slot = fieldSlots[slotOf(key, fieldSeed)];
+    if (slot == 0 || fieldNames[slot - 1].name != key)
+        return Field::None;
+    return fieldNames[slot - 1].field;
+}
+
+// Start decoding into definition; its typed fields are cleared
+void DefinitionDecoder::reset(TableDefinition &target)
+{
+    definition = &target;
+    depth = 0;
+    skipDepth = 0;
+    keySchema = nullptr;
+    indexes = nullptr;
+    throughput = nullptr;
+
+    target.tableName.clear();
+    target.keySchema.clear();
+    target.attributeDefinitions.clear();
+    target.globalSecondaryIndexes.clear();
+    target.localSecondaryIndexes.clear();
+    target.billingMode.clear();
+    target.hasProvisionedThroughput = false;
+    target.provisionedThroughput = ProvisionedThroughput();
+    target.streamEnabled = false;
+    target.streamViewType.clear();
+}
+
+bool DefinitionDecoder::enter(Context context)
+{
+    if (depth == maxDepth)
+        skipDepth = 1;
+    else
+        frames[depth++] = {context, Field::None};
+    return true;
+}
+
+bool DefinitionDecoder::leave()
+{
+    if (skipDepth > 0)
+        --skipDepth;
+    else if (depth > 0)
+        --depth;
+    return true;
+}
+
+bool DefinitionDecoder::Bool(bool value)
+{
+    if (skipDepth == 0 && depth > 0 && frames[depth - 1].context == Context::Stream &&
+        frames[depth - 1].field == Field::StreamEnabled)
+        definition->streamEnabled = value;
+    return true;
+}
+
+bool DefinitionDecoder::Integer(long long value)
+{
+    if (skipDepth > 0 || depth == 0 || frames[depth - 1].context != Context::Throughput)
+        return true;
+
+    if (frames[depth - 1].field == Field::ReadCapacityUnits)
+        throughput->readCapacityUnits = value;
+    else if (frames[depth - 1].field == Field::WriteCapacityUnits)
+        throughput->writeCapacityUnits = value;
+    return true;
+}
+
+bool DefinitionDecoder::String(const char *value, rapidjson::SizeType length, bool)
+{
+    if (skipDepth > 0 || depth == 0)
+        return true;
+
+    const Frame &frame = frames[depth - 1];
+    string *target = nullptr;
+    switch (frame.context)
+    {
+    case Context::Root:
+        if (frame.field == Field::TableName)
+            target = &definition->tableName;
+        else if (frame.field == Field::BillingMode)
+            target = &definition->billingMode;
+        break;
+    case Context::KeySchemaElement:
+        if (frame.field == Field::AttributeName)
+            target = &keySchema->back().attributeName;
+        else if (frame.field == Field::KeyType)
+            target = &keySchema->back().keyType;
+        break;
+    case Context::AttributeDefinition:
+        if (frame.field == Field::AttributeName)
+            target = &definition->attributeDefinitions.back().attributeName;
+        else if (frame.field == Field::AttributeType)
+            target = &definition->attributeDefinitions.back().attributeType;
+        break;
+    case Context::Index:
+        if (frame.field == Field::IndexName)
+            target = &indexes->back().indexName;
+        break;
+    case Context::Projection:
+        if (frame.field == Field::ProjectionType)
+            target = &indexes->back().projectionType;
+        break;
+    case Context::NonKeyAttributes:
+        indexes->back().nonKeyAttributes.emplace_back(value, length);
+        break;
+    case Context::Stream:
+        if (frame.field == Field::StreamViewType)
+            target = &definition->streamViewType;
+        break;
+    default:
+        break;
+    }
+
+    if (target)
+        target->assign(value, length);
+    return true;
+}
+
+bool DefinitionDecoder::StartObject()
+{
+    if (skipDepth > 0)
+    {
+        ++skipDepth;
+        return true;
+    }
+    if (depth == 0)
+        return enter(Context::Root);
+
+    const Frame &parent = frames[depth - 1];
+    switch (parent.context)
+    {
+    case Context::KeySchema:
+        keySchema->emplace_back();
+        return enter(Context::KeySchemaElement);
+    case Context::AttributeDefinitions:
+        definition->attributeDefinitions.emplace_back();
+        return enter(Context::AttributeDefinition);
+    case Context::Indexes:
+        indexes->emplace_back();
+        return enter(Context::Index);
+    case Context::Root:
+        if (parent.field == Field::ProvisionedThroughput)
+        {
+            definition->hasProvisionedThroughput = true;
+            throughput = &definition->provisionedThroughput;
+            return enter(Context::Throughput);
+        }
+        if (parent.field == Field::StreamSpecification)
+            return enter(Context::Stream);
+        break;
+    case Context::Index:
+        if (parent.field == Field::ProvisionedThroughput)
+        {
+            indexes->back().hasProvisionedThroughput = true;
+            throughput = &indexes->back().provisionedThroughput;
+            return enter(Context::Throughput);
+        }
+        if (parent.field == Field::Projection)
+            return enter(Context::Projection);
+        break;
+    default:
+        break;
+    }
+
+    skipDepth = 1;
+    return true;
+}
+
+bool DefinitionDecoder::Key(const char *name, rapidjson::SizeType length, bool)
+{
+    if (skipDepth == 0 && depth > 0)
+        frames[depth - 1].field = lookupField(name, length);
+    return true;
+}
+
+bool DefinitionDecoder::EndObject(rapidjson::SizeType)
+{
+    return leave();
+}
+
+bool DefinitionDecoder::StartArray()
+{
+    if (skipDepth > 0)
+    {
+        ++skipDepth;
+        return true;
+    }
+
+    // A repeated member replaces the earlier one, as its last value wins
+    if (depth > 0)
+    {
+        const Frame &parent = frames[depth - 1];
+        if (parent.context == Context::Root)
+        {
+            switch (parent.field)
+            {
+            case Field::KeySchema:
+                keySchema = &definition->keySchema;
+                keySchema->clear();
+                return enter(Context::KeySchema);
+            case Field::AttributeDefinitions:
+                definition->attributeDefinitions.clear();
+                return enter(Context::AttributeDefinitions);
+            case Field::GlobalSecondaryIndexes:
+                indexes = &definition->globalSecondaryIndexes;
+                indexes->clear();
+                return enter(Context::Indexes);
+            case Field::LocalSecondaryIndexes:
+                indexes = &definition->localSecondaryIndexes;
+                indexes->clear();
+                return enter(Context::Indexes);
+            default:
+                break;
+            }
+        }
+        else if (parent.context == Context::Index && parent.field == Field::KeySchema)
+        {
+            keySchema = &indexes->back().keySchema;
+            keySchema->clear();
+            return enter(Context::KeySchema);
+        }
+        else if (parent.context == Context::Projection && parent.field == Field::NonKeyAttributes)
+        {
+            indexes->back().nonKeyAttributes.clear();
+            return enter(Context::NonKeyAttributes);
+        }
+    }
+
+    skipDepth = 1;
+    return true;
+}
+
+bool DefinitionDecoder::EndArray(rapidjson::SizeType)
+{
+    return leave();
+}
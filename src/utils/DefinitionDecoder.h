@@ -0,0 +1,110 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#ifndef DEFINITION_DECODER_H
+#define DEFINITION_DECODER_H
+
+#include <cstdint>
+#include <rapidjson/reader.h>
+#include "TableDefinition.h"
+
+using namespace std;
+
+// SAX handler that fills a TableDefinition straight from parser events,
+// without building a DOM. Member names are matched through a perfect hash
+// generated at compile time from the field table in DefinitionDecoder.cpp;
+// members the tool doesn't model are skipped whole. Shape errors are left
+// to the schema validator in front of it, so every event is accepted.
+class DefinitionDecoder : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, DefinitionDecoder>
+{
+public:
+    enum class Field : uint8_t
+    {
+        None,
+        TableName,
+        KeySchema,
+        AttributeDefinitions,
+        GlobalSecondaryIndexes,
+        LocalSecondaryIndexes,
+        BillingMode,
+        ProvisionedThroughput,
+        StreamSpecification,
+        AttributeName,
+        KeyType,
+        AttributeType,
+        IndexName,
+        Projection,
+        ProjectionType,
+        NonKeyAttributes,
+        ReadCapacityUnits,
+        WriteCapacityUnits,
+        StreamEnabled,
+        StreamViewType,
+    };
+
+    // Map a member name to its field, None if the tool doesn't model it
+    static Field lookupField(const char *name, size_t length);
+
+    // Start decoding into definition; its typed fields are cleared
+    void reset(TableDefinition &definition);
+
+    bool Default() { return true; }
+    bool Bool(bool value);
+    bool Int(int value) { return Integer(value); }
+    bool Uint(unsigned value) { return Integer(value); }
+    bool Int64(int64_t value) { return Integer(value); }
+    bool Uint64(uint64_t value) { return value <= INT64_MAX ? Integer(static_cast<long long>(value)) : true; }
+    bool String(const char *value, rapidjson::SizeType length, bool copy);
+    bool StartObject();
+    bool Key(const char *name, rapidjson::SizeType length, bool copy);
+    bool EndObject(rapidjson::SizeType memberCount);
+    bool StartArray();
+    bool EndArray(rapidjson::SizeType elementCount);
+
+private:
+    // Where the parser is, for the members that are decoded
+    enum class Context : uint8_t
+    {
+        Root,
+        KeySchema,
+        KeySchemaElement,
+        AttributeDefinitions,
+        AttributeDefinition,
+        Indexes,
+        Index,
+        Projection,
+        NonKeyAttributes,
+        Throughput,
+        Stream,
+    };
+
+    struct Frame
+    {
+        Context context;
+        Field field; // The member whose value comes next
+    };
+
+    // Modeled members nest at most this deep; anything deeper is skipped
+    static const int maxDepth = 8;
+
+    bool Integer(long long value);
+    bool enter(Context context);
+    bool leave();
+
+    TableDefinition *definition = nullptr;
+    Frame frames[maxDepth];
+    int depth = 0;
+    int skipDepth = 0; // Nesting inside a skipped value
+
+    // Targets of the innermost open array or object of each kind
+    vector<KeySchemaElement> *keySchema = nullptr;
+    vector<SecondaryIndex> *indexes = nullptr;
+    ProvisionedThroughput *throughput = nullptr;
+};
+
+#endif
@@ -0,0 +1,113 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#include <cstring>
+#include "DefinitionFilter.h"
+#include "DefinitionSource.h"
+
+namespace
+{
+    const char regexPrefix[] = "re:";
+
+    // The ECMAScript form of a glob
+    string globToRegex(const string &glob)
+    {
+        string out;
+        for (size_t i = 0; i < glob.size(); ++i)
+        {
+            char c = glob[i];
+            if (c == '*' && i + 1 < glob.size() && glob[i + 1] == '*')
+            {
+                out += ".*";
+                ++i;
+            }
+            else if (c == '*')
+                out += "[^/]*";
+            else if (c == '?')
+                out += "[^/]";
+            else if (c == '[' && glob.find(']', i + 2) != string::npos)
+            {
+                // A class is copied as is, with ! for negation and a
+                // leading ] taken literally, as in the shell
+                size_t end = glob.find(']', i + 2);
+                string body = glob.substr(i + 1, end - i - 1);
+                if (body[0] == '!')
+                    body[0] = '^';
+                if (body[0] == ']')
+                    body.insert(0, "\\");
+                out += "[" + body + "]";
+                i = end;
+            }
+            else
+            {
+                if (strchr("\\^$.|+(){}[]", c))
+                    out += '\\';
+                out += c;
+            }
+        }
+        return out;
+    }
+}
+
+// Add one pattern; false with error if it doesn't compile
+bool DefinitionFilter::add(const string &pattern, bool include, string &error)
+{
+    bool isRegex = pattern.compare(0, strlen(regexPrefix), regexPrefix) == 0;
+    string body = isRegex ? pattern.substr(strlen(regexPrefix)) : pattern;
+    bool matchesPath = body.find('/') != string::npos;
+    if (!isRegex && body.compare(0, 2, "./") == 0)
+        body.erase(0, 2);
+
+    // A glob like orders*.json names files, in any directory
+    bool matchesFileName = !isRegex && !matchesPath && isDefinitionFile(body);
+
+    Pattern compiled;
+    compiled.text = pattern;
+    try
+    {
+        string expression = isRegex ? body : globToRegex(body);
+        if (matchesFileName)
+            expression = "(?:.*/)?" + expression;
+        compiled.compiled = regex(expression, regex::ECMAScript | regex::optimize);
+    }
+    catch (const regex_error &e)
+    {
+        error = string(include ? "--include" : "--exclude") + " pattern '" + pattern + "' is invalid: " + e.what();
+        return false;
+    }
+
+    PatternSet &set = matchesPath || matchesFileName ? paths : tableNames;
+    (include ? set.include : set.exclude).push_back(std::move(compiled));
+    return true;
+}
+
+// The table name patterns as one string
+string DefinitionFilter::tableNameKey() const
+{
+    string key;
+    for (const auto &pattern : tableNames.include)
+        key += "|include " + pattern.text;
+    for (const auto &pattern : tableNames.exclude)
+        key += "|exclude " + pattern.text;
+    return key;
+}
+
+// Passes when no include is given or one matches, and no exclude matches
+bool DefinitionFilter::PatternSet::accepts(const string &text) const
+{
+    bool included = include.empty();
+    for (size_t i = 0; i < include.size() && !included; ++i)
+        included = regex_match(text, include[i].compiled);
+    if (!included)
+        return false;
+
+    for (const auto &pattern : exclude)
+        if (regex_match(text, pattern.compiled))
+            return false;
+    return true;
+}
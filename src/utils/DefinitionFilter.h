@@ -0,0 +1,67 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#ifndef DEFINITION_FILTER_H
+#define DEFINITION_FILTER_H
+
+#include <regex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// The --include and --exclude patterns of a run. A pattern containing a '/'
+// matches the file path relative to -p, which no table name can contain,
+// so it is decided before the file is read; "./" marks a top-level file.
+// A glob ending in a definition file extension (orders*.json) matches the
+// file name in any directory. Any other pattern matches TableName. Patterns
+// are globs (* and ? stay within one path segment, ** crosses them) unless
+// they start with "re:", for a regular expression. Either way they must
+// match the whole text and are compiled once, when added.
+class DefinitionFilter
+{
+public:
+    // Add one pattern; false with error if it doesn't compile
+    bool add(const string &pattern, bool include, string &error);
+
+    bool filtersPaths() const { return !paths.empty(); }
+    bool filtersTableNames() const { return !tableNames.empty(); }
+
+    // Whether a file passes the path patterns, from its name alone
+    bool acceptsPath(const string &filename) const { return paths.accepts(filename); }
+
+    // Whether a definition passes the table name patterns. One whose
+    // TableName can't be read passes, so its check reports the problem
+    // instead of an --include hiding it.
+    bool acceptsTableName(const string &tableName) const { return tableName.empty() || tableNames.accepts(tableName); }
+
+    // The table name patterns as one string, for the definition cache key
+    string tableNameKey() const;
+
+private:
+    struct Pattern
+    {
+        string text;
+        regex compiled;
+    };
+
+    // Passes when no include is given or one matches, and no exclude matches
+    struct PatternSet
+    {
+        vector<Pattern> include;
+        vector<Pattern> exclude;
+
+        bool empty() const { return include.empty() && exclude.empty(); }
+        bool accepts(const string &text) const;
+    };
+
+    PatternSet paths;
+    PatternSet tableNames;
+};
+
+#endif
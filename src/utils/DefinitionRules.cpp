@@ -0,0 +1,193 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#include <unordered_set>
+#include "DefinitionRules.h"
+
+namespace
+{
+    const size_t maxGlobalSecondaryIndexes = 20;
+    const size_t maxLocalSecondaryIndexes = 5;
+    const size_t maxProjectedAttributes = 100;
+
+    using Violations = vector<string>;
+
+    // Table and index names: 3-255 characters from [a-zA-Z0-9_.-]
+    bool isValidName(const string &name)
+    {
+        if (name.size() < 3 || name.size() > 255)
+            return false;
+        for (char c : name)
+        {
+            bool allowed = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '.' || c == '-';
+            if (!allowed)
+                return false;
+        }
+        return true;
+    }
+
+    // One HASH key first, optionally followed by one RANGE key
+    void checkKeySchema(const vector<KeySchemaElement> &keySchema, const string &owner, Violations &violations)
+    {
+        if (keySchema.empty() || keySchema[0].keyType != "HASH")
+            violations.push_back(owner + " must start with a HASH key");
+        if (keySchema.size() == 2 && keySchema[1].keyType != "RANGE")
+            violations.push_back(owner + " can only add a RANGE key after the HASH key");
+    }
+
+    bool hasProvisionedMode(const TableDefinition &definition)
+    {
+        return definition.billingMode.empty() || definition.billingMode == "PROVISIONED";
+    }
+
+    void checkNames(const TableDefinition &definition, Violations &violations)
+    {
+        if (!isValidName(definition.tableName))
+            violations.push_back("TableName '" + definition.tableName + "' must be 3-255 characters of a-z, A-Z, 0-9, '_', '-' and '.'");
+
+        unordered_set<string> indexNames;
+        for (const auto *indexes : {&definition.globalSecondaryIndexes, &definition.localSecondaryIndexes})
+        {
+            for (const auto &index : *indexes)
+            {
+                if (!isValidName(index.indexName))
+                    violations.push_back("IndexName '" + index.indexName + "' must be 3-255 characters of a-z, A-Z, 0-9, '_', '-' and '.'");
+                if (!indexNames.insert(index.indexName).second)
+                    violations.push_back("IndexName '" + index.indexName + "' is used more than once");
+            }
+        }
+
+        for (const auto &attribute : definition.attributeDefinitions)
+        {
+            if (attribute.attributeName.empty() || attribute.attributeName.size() > 255)
+                violations.push_back("AttributeName '" + attribute.attributeName + "' must be 1-255 bytes");
+        }
+    }
+
+    void checkIndexLimits(const TableDefinition &definition, Violations &violations)
+    {
+        if (definition.globalSecondaryIndexes.size() > maxGlobalSecondaryIndexes)
+            violations.push_back(to_string(definition.globalSecondaryIndexes.size()) + " global secondary indexes exceed the limit of " +
+                                 to_string(maxGlobalSecondaryIndexes));
+        if (definition.localSecondaryIndexes.size() > maxLocalSecondaryIndexes)
+            violations.push_back(to_string(definition.localSecondaryIndexes.size()) + " local secondary indexes exceed the limit of " +
+                                 to_string(maxLocalSecondaryIndexes));
+
+        size_t projected = 0;
+        for (const auto *indexes : {&definition.globalSecondaryIndexes, &definition.localSecondaryIndexes})
+        {
+            for (const auto &index : *indexes)
+            {
+                if (index.projectionType == "INCLUDE" && index.nonKeyAttributes.empty())
+                    violations.push_back("index " + index.indexName + " has an INCLUDE projection without NonKeyAttributes");
+                if (index.projectionType != "INCLUDE" && !index.nonKeyAttributes.empty())
+                    violations.push_back("index " + index.indexName + " lists NonKeyAttributes without an INCLUDE projection");
+                projected += index.nonKeyAttributes.size();
+            }
+        }
+        if (projected > maxProjectedAttributes)
+            violations.push_back(to_string(projected) + " projected NonKeyAttributes across all indexes exceed the limit of " +
+                                 to_string(maxProjectedAttributes));
+    }
+
+    // Every key attribute must be defined, and every definition must be a key somewhere
+    void checkAttributes(const TableDefinition &definition, Violations &violations)
+    {
+        unordered_set<string> defined;
+        for (const auto &attribute : definition.attributeDefinitions)
+        {
+            if (!defined.insert(attribute.attributeName).second)
+                violations.push_back("attribute " + attribute.attributeName + " is defined more than once");
+        }
+
+        unordered_set<string> used;
+        auto useKeys = [&](const vector<KeySchemaElement> &keySchema, const string &owner)
+        {
+            for (const auto &key : keySchema)
+            {
+                used.insert(key.attributeName);
+                if (defined.count(key.attributeName) == 0)
+                    violations.push_back(owner + " uses " + key.attributeName + ", which is missing from AttributeDefinitions");
+            }
+        };
+
+        checkKeySchema(definition.keySchema, "KeySchema", violations);
+        useKeys(definition.keySchema, "KeySchema");
+        for (const auto &index : definition.globalSecondaryIndexes)
+        {
+            checkKeySchema(index.keySchema, "index " + index.indexName, violations);
+            useKeys(index.keySchema, "index " + index.indexName);
+        }
+        for (const auto &index : definition.localSecondaryIndexes)
+        {
+            checkKeySchema(index.keySchema, "index " + index.indexName, violations);
+            useKeys(index.keySchema, "index " + index.indexName);
+
+            // A local index shares the table's partition key and needs its own sort key
+            bool tableIsComposite = definition.keySchema.size() == 2;
+            if (!tableIsComposite)
+                violations.push_back("local index " + index.indexName + " needs a table with a RANGE key");
+            else if (index.keySchema.size() != 2 || index.keySchema[0].attributeName != definition.keySchema[0].attributeName)
+                violations.push_back("local index " + index.indexName + " must use the table's HASH key and a RANGE key");
+        }
+
+        for (const auto &attribute : definition.attributeDefinitions)
+        {
+            if (used.count(attribute.attributeName) == 0)
+                violations.push_back("attribute " + attribute.attributeName + " is defined but not used by any key schema");
+        }
+    }
+
+    // PROVISIONED needs throughput on the table and every global index; PAY_PER_REQUEST allows none
+    void checkBilling(const TableDefinition &definition, Violations &violations)
+    {
+        if (hasProvisionedMode(definition))
+        {
+            if (!definition.hasProvisionedThroughput)
+                violations.push_back("ProvisionedThroughput is required unless BillingMode is PAY_PER_REQUEST");
+            for (const auto &index : definition.globalSecondaryIndexes)
+            {
+                if (!index.hasProvisionedThroughput)
+                    violations.push_back("index " + index.indexName + " needs ProvisionedThroughput unless BillingMode is PAY_PER_REQUEST");
+            }
+            return;
+        }
+
+        if (definition.hasProvisionedThroughput)
+            violations.push_back("ProvisionedThroughput can't be set with BillingMode PAY_PER_REQUEST");
+        for (const auto &index : definition.globalSecondaryIndexes)
+        {
+            if (index.hasProvisionedThroughput)
+                violations.push_back("index " + index.indexName + " can't set ProvisionedThroughput with BillingMode PAY_PER_REQUEST");
+        }
+    }
+
+    void checkStream(const TableDefinition &definition, Violations &violations)
+    {
+        if (definition.streamEnabled && definition.streamViewType.empty())
+            violations.push_back("StreamSpecification enables a stream without a StreamViewType");
+    }
+
+    // The rules, in the order their violations are reported
+    void (*const rules[])(const TableDefinition &, Violations &) = {
+        checkNames,
+        checkIndexLimits,
+        checkAttributes,
+        checkBilling,
+        checkStream,
+    };
+}
+
+// Check a decoded definition and return every violation found
+vector<string> checkDefinitionRules(const TableDefinition &definition)
+{
+    Violations violations;
+    for (auto rule : rules)
+        rule(definition, violations);
+    return violations;
+}
@@ -0,0 +1,23 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#ifndef DEFINITION_RULES_H
+#define DEFINITION_RULES_H
+
+#include <string>
+#include <vector>
+#include "TableDefinition.h"
+
+using namespace std;
+
+// Check a decoded definition against the DynamoDB rules that a schema can't
+// express (index limits, key/attribute consistency, naming, billing) and
+// return every violation found, in rule order.
+vector<string> checkDefinitionRules(const TableDefinition &definition);
+
+#endif
@@ -0,0 +1,157 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "DefinitionScanner.h"
+#include "DefinitionSource.h"
+#include "spdlog/spdlog.h"
+
+DefinitionScanner::~DefinitionScanner()
+{
+    for (auto &walker : walkers)
+        walker.join();
+    if (rootFd >= 0)
+        ::close(rootFd);
+}
+
+// Start walking root; false if it can't be opened
+bool DefinitionScanner::start(const string &root, bool walkSubdirectories, size_t threadCount, string &error)
+{
+    rootFd = open(root.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (rootFd < 0)
+    {
+        error = "Could not open directory " + root + ": " + strerror(errno);
+        return false;
+    }
+
+    rootPath = root;
+    recursive = walkSubdirectories;
+    directories.push_back("");
+    directoriesFound = 1;
+
+    // A flat directory is a single scan
+    size_t count = recursive ? max<size_t>(threadCount, 1) : 1;
+    for (size_t i = 0; i < count; ++i)
+        walkers.emplace_back(&DefinitionScanner::walkLoop, this);
+    return true;
+}
+
+// Wait for the next definition file; false once the walk is over
+bool DefinitionScanner::next(string &path)
+{
+    unique_lock<mutex> lock(stateMutex);
+    stateChanged.wait(lock, [this]
+                      { return !files.empty() || finished; });
+    if (files.empty())
+        return false;
+
+    path = std::move(files.front());
+    files.pop_front();
+    return true;
+}
+
+// Directories found so far
+size_t DefinitionScanner::directoryCount()
+{
+    lock_guard<mutex> lock(stateMutex);
+    return directoriesFound;
+}
+
+void DefinitionScanner::walkLoop()
+{
+    unique_lock<mutex> lock(stateMutex);
+    while (true)
+    {
+        // Another thread may still find subdirectories while it scans
+        stateChanged.wait(lock, [this]
+                          { return !directories.empty() || scanning == 0; });
+        if (directories.empty())
+        {
+            finished = true;
+            stateChanged.notify_all();
+            return;
+        }
+
+        string relative = std::move(directories.front());
+        directories.pop_front();
+        ++scanning;
+        lock.unlock();
+        scanDirectory(relative);
+        lock.lock();
+        --scanning;
+        stateChanged.notify_all();
+    }
+}
+
+void DefinitionScanner::scanDirectory(const string &relative)
+{
+    int fd = relative.empty() ? dup(rootFd) : openat(rootFd, relative.c_str(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    DIR *dir = fd >= 0 ? fdopendir(fd) : nullptr;
+    if (!dir)
+    {
+        int openErrno = errno;
+        if (fd >= 0)
+            ::close(fd);
+        spdlog::get("file_logger")->warn("Could not open directory {}/{}: {}", rootPath, relative, strerror(openErrno));
+        return;
+    }
+
+    // Everything found here is published at once, under one lock
+    vector<string> foundDirectories;
+    vector<string> foundFiles;
+    string prefix = relative.empty() ? "" : relative + "/";
+    struct dirent *ent;
+    while ((ent = readdir(dir)) != nullptr)
+    {
+        const char *name = ent->d_name;
+        if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0)
+            continue;
+
+        unsigned char type = ent->d_type;
+        if (type == DT_UNKNOWN || type == DT_LNK)
+        {
+            // Links count as the file they point to, but are never descended into
+            struct stat info;
+            if (fstatat(dirfd(dir), name, &info, 0) != 0)
+                continue;
+            if (S_ISREG(info.st_mode))
+                type = DT_REG;
+            else if (S_ISDIR(info.st_mode) && ent->d_type == DT_UNKNOWN)
+                type = DT_DIR;
+            else
+                continue;
+        }
+
+        if (type == DT_DIR)
+        {
+            if (recursive && name[0] != '.')
+                foundDirectories.push_back(prefix + name);
+        }
+        else if (type == DT_REG && isDefinitionFile(name))
+        {
+            foundFiles.push_back(prefix + name);
+        }
+    }
+    closedir(dir);
+
+    if (foundDirectories.empty() && foundFiles.empty())
+        return;
+
+    lock_guard<mutex> lock(stateMutex);
+    for (auto &directory : foundDirectories)
+        directories.push_back(std::move(directory));
+    for (auto &file : foundFiles)
+        files.push_back(std::move(file));
+    directoriesFound += foundDirectories.size();
+    stateChanged.notify_all();
+}
@@ -0,0 +1,66 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#ifndef DEFINITION_SCANNER_H
+#define DEFINITION_SCANNER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Finds definition files under a directory on background threads and hands
+// them out as they are found, so checking can start before the listing is
+// complete. Directories are opened relative to the root with openat() and
+// entries are classified by d_type, falling back to fstatat() only when
+// the file system doesn't report it. With recursive, several threads walk
+// subtrees in parallel; hidden directories and symbolic links to
+// directories are not entered. Paths are relative to the root; the order
+// in which they arrive is not defined.
+class DefinitionScanner
+{
+public:
+    DefinitionScanner() = default;
+    ~DefinitionScanner();
+
+    DefinitionScanner(const DefinitionScanner &) = delete;
+    DefinitionScanner &operator=(const DefinitionScanner &) = delete;
+
+    // Start walking root; false if it can't be opened
+    bool start(const string &root, bool recursive, size_t threadCount, string &error);
+
+    // Wait for the next definition file; false once the walk is over
+    bool next(string &path);
+
+    // Directories found so far
+    size_t directoryCount();
+
+private:
+    void walkLoop();
+    void scanDirectory(const string &relative);
+
+    int rootFd = -1;
+    string rootPath;
+    bool recursive = false;
+    vector<thread> walkers;
+
+    mutex stateMutex;
+    condition_variable stateChanged;
+    deque<string> directories; // Found but not scanned yet
+    deque<string> files;       // Found but not handed out yet
+    size_t scanning = 0;       // Directories being scanned right now
+    size_t directoriesFound = 0;
+    bool finished = false;
+};
+
+#endif
@@ -0,0 +1,218 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#include <rapidjson/document.h>
+#include <rapidjson/error/en.h>
+#include <rapidjson/schema.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+#include "DefinitionSchema.h"
+
+using namespace rapidjson;
+
+namespace
+{
+    // The CreateTable input. Every member CreateTable accepts is listed, so a
+    // misspelled one fails here rather than at DynamoDB mid-run; the ones
+    // the tool doesn't decode (Tags, SSESpecification, ...) are only
+    // checked for shape and sent as they are.
+    const char *const createTableSchemaJson = R"json({
+        "type": "object",
+        "required": ["TableName", "KeySchema", "AttributeDefinitions"],
+        "properties": {
+            "TableName": {"type": "string"},
+            "KeySchema": {"$ref": "#/definitions/keySchema"},
+            "AttributeDefinitions": {
+                "type": "array",
+                "minItems": 1,
+                "items": {
+                    "type": "object",
+                    "required": ["AttributeName", "AttributeType"],
+                    "properties": {
+                        "AttributeName": {"type": "string"},
+                        "AttributeType": {"enum": ["S", "N", "B"]}
+                    },
+                    "additionalProperties": false
+                }
+            },
+            "BillingMode": {"enum": ["PROVISIONED", "PAY_PER_REQUEST"]},
+            "ProvisionedThroughput": {"$ref": "#/definitions/throughput"},
+            "GlobalSecondaryIndexes": {
+                "type": "array",
+                "items": {
+                    "type": "object",
+                    "required": ["IndexName", "KeySchema", "Projection"],
+                    "properties": {
+                        "IndexName": {"type": "string"},
+                        "KeySchema": {"$ref": "#/definitions/keySchema"},
+                        "Projection": {"$ref": "#/definitions/projection"},
+                        "ProvisionedThroughput": {"$ref": "#/definitions/throughput"},
+                        "OnDemandThroughput": {"$ref": "#/definitions/onDemandThroughput"},
+                        "WarmThroughput": {"$ref": "#/definitions/warmThroughput"}
+                    },
+                    "additionalProperties": false
+                }
+            },
+            "LocalSecondaryIndexes": {
+                "type": "array",
+                "items": {
+                    "type": "object",
+                    "required": ["IndexName", "KeySchema", "Projection"],
+                    "properties": {
+                        "IndexName": {"type": "string"},
+                        "KeySchema": {"$ref": "#/definitions/keySchema"},
+                        "Projection": {"$ref": "#/definitions/projection"}
+                    },
+                    "additionalProperties": false
+                }
+            },
+            "StreamSpecification": {
+                "type": "object",
+                "required": ["StreamEnabled"],
+                "properties": {
+                    "StreamEnabled": {"type": "boolean"},
+                    "StreamViewType": {"enum": ["NEW_IMAGE", "OLD_IMAGE", "NEW_AND_OLD_IMAGES", "KEYS_ONLY"]}
+                },
+                "additionalProperties": false
+            },
+            "SSESpecification": {
+                "type": "object",
+                "properties": {
+                    "Enabled": {"type": "boolean"},
+                    "SSEType": {"enum": ["AES256", "KMS"]},
+                    "KMSMasterKeyId": {"type": "string"}
+                },
+                "additionalProperties": false
+            },
+            "TableClass": {"enum": ["STANDARD", "STANDARD_INFREQUENT_ACCESS"]},
+            "DeletionProtectionEnabled": {"type": "boolean"},
+            "ResourcePolicy": {"type": "string"},
+            "OnDemandThroughput": {"$ref": "#/definitions/onDemandThroughput"},
+            "WarmThroughput": {"$ref": "#/definitions/warmThroughput"},
+            "Tags": {
+                "type": "array",
+                "items": {
+                    "type": "object",
+                    "required": ["Key", "Value"],
+                    "properties": {
+                        "Key": {"type": "string"},
+                        "Value": {"type": "string"}
+                    },
+                    "additionalProperties": false
+                }
+            }
+        },
+        "additionalProperties": false,
+        "definitions": {
+            "keySchema": {
+                "type": "array",
+                "minItems": 1,
+                "maxItems": 2,
+                "items": {
+                    "type": "object",
+                    "required": ["AttributeName", "KeyType"],
+                    "properties": {
+                        "AttributeName": {"type": "string"},
+                        "KeyType": {"enum": ["HASH", "RANGE"]}
+                    },
+                    "additionalProperties": false
+                }
+            },
+            "throughput": {
+                "type": "object",
+                "required": ["ReadCapacityUnits", "WriteCapacityUnits"],
+                "properties": {
+                    "ReadCapacityUnits": {"type": "integer", "minimum": 1},
+                    "WriteCapacityUnits": {"type": "integer", "minimum": 1}
+                },
+                "additionalProperties": false
+            },
+            "onDemandThroughput": {
+                "type": "object",
+                "properties": {
+                    "MaxReadRequestUnits": {"type": "integer"},
+                    "MaxWriteRequestUnits": {"type": "integer"}
+                },
+                "additionalProperties": false
+            },
+            "warmThroughput": {
+                "type": "object",
+                "properties": {
+                    "ReadUnitsPerSecond": {"type": "integer"},
+                    "WriteUnitsPerSecond": {"type": "integer"}
+                },
+                "additionalProperties": false
+            },
+            "projection": {
+                "type": "object",
+                "properties": {
+                    "ProjectionType": {"enum": ["ALL", "KEYS_ONLY", "INCLUDE"]},
+                    "NonKeyAttributes": {"type": "array", "items": {"type": "string"}}
+                },
+                "additionalProperties": false
+            }
+        }
+    })json";
+
+    // A detail value as text: strings without quotes, arrays comma-separated
+    template <typename ValueType>
+    string detailText(const ValueType &value)
+    {
+        if (value.IsString())
+            return string(value.GetString(), value.GetStringLength());
+        if (value.IsArray())
+        {
+            string text;
+            for (const auto &item : value.GetArray())
+                text += (text.empty() ? "" : ", ") + detailText(item);
+            return text;
+        }
+
+        StringBuffer buffer;
+        Writer<StringBuffer> writer(buffer);
+        value.Accept(writer);
+        return string(buffer.GetString(), buffer.GetSize());
+    }
+}
+
+// Compiled on first use; SchemaDocument is immutable and safe to share
+const SchemaDocument &createTableSchema()
+{
+    static const SchemaDocument schema = []
+    {
+        Document document;
+        document.Parse(createTableSchemaJson);
+        return SchemaDocument(document);
+    }();
+    return schema;
+}
+
+// "<pointer>: <message>" with rapidjson's %placeholders filled in
+string describeSchemaError(const DefinitionValidator &validator)
+{
+    StringBuffer pointer;
+    validator.GetInvalidDocumentPointer().Stringify(pointer);
+    string path = pointer.GetSize() == 0 ? "/" : string(pointer.GetString(), pointer.GetSize());
+
+    string message = GetValidateError_En(validator.GetInvalidSchemaCode());
+    auto keyword = validator.GetError().FindMember(validator.GetInvalidSchemaKeyword());
+    if (keyword != validator.GetError().MemberEnd())
+    {
+        const auto &detail = keyword->value.IsArray() && !keyword->value.Empty() ? keyword->value[0] : keyword->value;
+        for (const char *name : {"actual", "expected", "missing", "disallowed", "duplicates"})
+        {
+            string placeholder = string("%") + name;
+            size_t at = message.find(placeholder);
+            if (at != string::npos && detail.IsObject() && detail.HasMember(name))
+                message.replace(at, placeholder.size(), detailText(detail[name]));
+        }
+    }
+    if (!message.empty() && message.back() == '.')
+        message.pop_back();
+    return path + ": " + message;
+}
@@ -0,0 +1,31 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#ifndef DEFINITION_SCHEMA_H
+#define DEFINITION_SCHEMA_H
+
+#include <string>
+#include <rapidjson/schema.h>
+#include "DefinitionDecoder.h"
+
+using namespace std;
+
+// Checks parser events against the embedded CreateTable input schema and
+// passes the ones that conform on to a decoder, so a definition is
+// validated and decoded in the same pass
+using DefinitionValidator = rapidjson::GenericSchemaValidator<rapidjson::SchemaDocument, DefinitionDecoder>;
+
+// The schema, compiled once and shared by all threads; each thread keeps
+// its own validator
+const rapidjson::SchemaDocument &createTableSchema();
+
+// Why validation failed, naming the offending member as a JSON Pointer,
+// e.g. "/KeySchema/0/KeyType: ..."
+string describeSchemaError(const DefinitionValidator &validator);
+
+#endif
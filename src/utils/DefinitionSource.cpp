@@ -0,0 +1,207 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#include <cstring>
+#include <string_view>
+#include "DefinitionSource.h"
+
+namespace
+{
+    bool endsWith(const string &text, const char *suffix)
+    {
+        size_t length = strlen(suffix);
+        return text.size() > length && text.compare(text.size() - length, length, suffix) == 0;
+    }
+
+    bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    bool isLineBundle(const string &filename)
+    {
+        return endsWith(filename, ".ndjson") || endsWith(filename, ".jsonl");
+    }
+
+    // One definition per non-blank line
+    void splitLines(const char *data, size_t size, const function<void(size_t, size_t)> &entry)
+    {
+        size_t start = 0;
+        while (start < size)
+        {
+            const char *newline = static_cast<const char *>(memchr(data + start, '\n', size - start));
+            size_t end = newline ? static_cast<size_t>(newline - data) : size;
+
+            for (size_t i = start; i < end; ++i)
+            {
+                if (!isSpace(data[i]))
+                {
+                    entry(start, end - start);
+                    break;
+                }
+            }
+            start = end + 1;
+        }
+    }
+
+    // Element ranges of a top-level array of objects. Only brackets and
+    // strings are tracked; each entry's JSON is checked when it is parsed.
+    bool splitArray(const char *data, size_t size, size_t i, const function<void(size_t, size_t)> &entry, string &error)
+    {
+        int depth = 0;
+        size_t start = 0;
+        bool inString = false;
+
+        for (++i; i < size; ++i)
+        {
+            char c = data[i];
+            if (inString)
+            {
+                if (c == '\\')
+                    ++i;
+                else if (c == '"')
+                    inString = false;
+                continue;
+            }
+
+            switch (c)
+            {
+            case '"':
+                if (depth == 0)
+                {
+                    error = "bundle entries must be objects (entry at offset " + to_string(i) + ")";
+                    return false;
+                }
+                inString = true;
+                break;
+            case '{':
+            case '[':
+                if (depth == 0)
+                {
+                    if (c == '[')
+                    {
+                        error = "bundle entries must be objects (entry at offset " + to_string(i) + ")";
+                        return false;
+                    }
+                    start = i;
+                }
+                ++depth;
+                break;
+            case '}':
+            case ']':
+                if (depth == 0)
+                {
+                    if (c == '}')
+                    {
+                        error = "unbalanced '}' at offset " + to_string(i);
+                        return false;
+                    }
+                    for (++i; i < size; ++i)
+                    {
+                        if (!isSpace(data[i]))
+                        {
+                            error = "unexpected content after the bundle array at offset " + to_string(i);
+                            return false;
+                        }
+                    }
+                    return true;
+                }
+                if (--depth == 0)
+                    entry(start, i + 1 - start);
+                break;
+            default:
+                if (depth == 0 && c != ',' && !isSpace(c))
+                {
+                    error = "bundle entries must be objects (entry at offset " + to_string(i) + ")";
+                    return false;
+                }
+                break;
+            }
+        }
+
+        error = "the bundle array is not terminated";
+        return false;
+    }
+}
+
+// Definition files the directory scan picks up
+bool isDefinitionFile(const string &filename)
+{
+    return endsWith(filename, ".json") || isLineBundle(filename);
+}
+
+// Call entry(offset, length) for every definition in a mapped file, in order
+bool splitDefinitionFile(const string &filename, const char *data, size_t size, bool &wholeFile,
+                         const function<void(size_t offset, size_t length)> &entry, string &error)
+{
+    if (isLineBundle(filename))
+    {
+        wholeFile = false;
+        splitLines(data, size, entry);
+        return true;
+    }
+
+    // A .json file whose top-level value is an array is a bundle
+    size_t first = 0;
+    while (first < size && isSpace(data[first]))
+        ++first;
+    if (first < size && data[first] == '[')
+    {
+        wholeFile = false;
+        return splitArray(data, size, first, entry, error);
+    }
+
+    wholeFile = true;
+    entry(0, size);
+    return true;
+}
+
+// Read the text of one definition back for its CreateTable request
+bool readDefinitionText(const string &jsonDir, const DefinitionSource &source, string &text, string &error)
+{
+    MappedFile file;
+    if (!file.open(jsonDir + "/" + source.filename, error))
+        return false;
+
+    size_t offset = source.wholeFile ? 0 : source.offset;
+    size_t length = source.wholeFile ? file.size() : source.length;
+    if (offset + length > file.size() || hash<string_view>{}(string_view(file.data() + offset, length)) != source.textHash)
+    {
+        error = "the file changed after it was checked; it is applied on the next run";
+        return false;
+    }
+
+    text.assign(file.data() + offset, length);
+    return true;
+}
+
+void DefinitionText::open(const shared_ptr<MappedFile> &loaded, const DefinitionSource &source)
+{
+    close();
+    if (source.wholeFile)
+    {
+        file = loaded;
+        text = file->data();
+        length = file->size();
+        return;
+    }
+
+    entryCopy.resize(source.length + 1);
+    memcpy(entryCopy.data(), loaded->data() + source.offset, source.length);
+    entryCopy[source.length] = '\0';
+
+    text = entryCopy.data();
+    length = source.length;
+}
+
+void DefinitionText::close()
+{
+    file.reset();
+    text = nullptr;
+    length = 0;
+}
@@ -0,0 +1,80 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#ifndef DEFINITION_SOURCE_H
+#define DEFINITION_SOURCE_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "FileVersion.h"
+#include "MappedFile.h"
+#include "TableDefinition.h"
+
+using namespace std;
+
+// Where one table definition lives: a whole .json file, or one entry of a
+// bundle (a .json file holding an array of definitions, or a .ndjson/.jsonl
+// file with one definition per line). The pre-flight stage keeps what it
+// decoded and checked, but not the request body: holding every body until
+// its table is created would make memory grow with the whole tree. The
+// body is read back from its byte range when the table is created, and is
+// only applied if it hashes the same as the text pre-flight checked. A
+// template is expanded into one source per tenant, all sharing the parsed
+// template.
+struct DefinitionSource
+{
+    string filename; // File in jsonDir
+    string label;    // filename, or filename#N for the Nth entry of a bundle, plus @tenant for a template
+    bool wholeFile = true;
+    size_t offset = 0; // Byte range of a bundle entry
+    size_t length = 0;
+    string invalidReason; // Pre-flight error, for definitions let through by --keep-going
+    string tenant; // Set for a tenant's copy of a template
+    shared_ptr<const TableDefinition> parsed; // Set for every valid definition, without requestJson; the template for a tenant's copy
+    size_t textHash = 0;                      // Of the text pre-flight checked
+    shared_ptr<FileVersion> version;          // The file as pre-flight read it, shared by its sources; set for the cache
+};
+
+// Definition files the directory scan picks up
+bool isDefinitionFile(const string &filename);
+
+// Call entry(offset, length) for every definition in a mapped file, in order.
+// A plain definition file yields one whole-file entry (wholeFile is set).
+// Bundles are split by scanning bytes, without parsing the entries.
+bool splitDefinitionFile(const string &filename, const char *data, size_t size, bool &wholeFile,
+                         const function<void(size_t offset, size_t length)> &entry, string &error);
+
+// Read the text of one definition back for its CreateTable request; false
+// with error if the file can't be read or no longer holds the text
+// pre-flight checked
+bool readDefinitionText(const string &jsonDir, const DefinitionSource &source, string &text, string &error);
+
+// The text of one definition, NUL-terminated and writable for in-situ
+// parsing, taken from the file the splitter already loaded. Whole files are
+// used straight from their mapping, which is kept alive until close();
+// bundle entries are copied into a buffer that is reused by the next open().
+class DefinitionText
+{
+public:
+    void open(const shared_ptr<MappedFile> &file, const DefinitionSource &source);
+    void close();
+
+    char *data() { return text; }
+    size_t size() const { return length; }
+
+private:
+    shared_ptr<MappedFile> file;
+    vector<char> entryCopy;
+    char *text = nullptr;
+    size_t length = 0;
+};
+
+#endif
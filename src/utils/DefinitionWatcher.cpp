@@ -0,0 +1,220 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#include "DefinitionWatcher.h"
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "DefinitionScanner.h"
+#include "DefinitionSource.h"
+#include "spdlog/spdlog.h"
+
+namespace
+{
+    // Written in place, or saved through a rename; new subdirectories
+    const uint32_t watchMask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR | IN_DONT_FOLLOW;
+
+    string joinPath(const string &directory, const string &name)
+    {
+        return directory.empty() ? name : directory + "/" + name;
+    }
+}
+
+DefinitionWatcher::~DefinitionWatcher()
+{
+    if (fd >= 0)
+        close(fd);
+}
+
+bool DefinitionWatcher::start(const string &root, bool watchSubdirectories, string &error)
+{
+    fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0)
+    {
+        error = string("Could not start watching: ") + strerror(errno);
+        return false;
+    }
+
+    rootPath = root;
+    recursive = watchSubdirectories;
+    watchTree("", nullptr);
+    if (directories.empty())
+    {
+        error = "Could not watch " + root + ": " + strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+// Watch a directory and, with recursive, the directories below it. Files
+// already in a directory that appeared after start() go to existingFiles,
+// since they were written before the watch existed.
+void DefinitionWatcher::watchTree(const string &relative, set<string> *existingFiles)
+{
+    string path = relative.empty() ? rootPath : rootPath + "/" + relative;
+    int wd = inotify_add_watch(fd, path.c_str(), watchMask);
+    if (wd < 0)
+    {
+        spdlog::get("file_logger")->warn("Could not watch {}: {}", path, strerror(errno));
+        return;
+    }
+    directories[wd] = relative;
+
+    if (!recursive && !existingFiles)
+        return;
+
+    DIR *dir = opendir(path.c_str());
+    if (!dir)
+        return;
+    struct dirent *ent;
+    while ((ent = readdir(dir)) != nullptr)
+    {
+        const char *name = ent->d_name;
+        if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0)
+            continue;
+
+        unsigned char type = ent->d_type;
+        if (type == DT_UNKNOWN)
+        {
+            struct stat info;
+            if (fstatat(dirfd(dir), name, &info, AT_SYMLINK_NOFOLLOW) != 0)
+                continue;
+            type = S_ISDIR(info.st_mode) ? DT_DIR : S_ISREG(info.st_mode) ? DT_REG : DT_UNKNOWN;
+        }
+
+        if (type == DT_DIR && recursive && name[0] != '.')
+            watchTree(joinPath(relative, name), existingFiles);
+        else if (type != DT_DIR && existingFiles && isDefinitionFile(name))
+            existingFiles->insert(joinPath(relative, name));
+    }
+    closedir(dir);
+}
+
+// Every definition file below a directory
+void DefinitionWatcher::listFiles(const string &relative, set<string> &files)
+{
+    DefinitionScanner scanner;
+    string error;
+    if (!scanner.start(relative.empty() ? rootPath : rootPath + "/" + relative, recursive, 1, error))
+        return;
+    string path;
+    while (scanner.next(path))
+        files.insert(joinPath(relative, path));
+}
+
+bool DefinitionWatcher::readEvents(set<string> &changed, string &error)
+{
+    alignas(struct inotify_event) char buffer[16 * 1024];
+    while (true)
+    {
+        ssize_t length = read(fd, buffer, sizeof(buffer));
+        if (length < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return true;
+            if (errno == EINTR)
+                continue;
+            error = string("Could not read file events: ") + strerror(errno);
+            return false;
+        }
+
+        for (char *at = buffer; at < buffer + length;)
+        {
+            const struct inotify_event *event = reinterpret_cast<const struct inotify_event *>(at);
+            at += sizeof(struct inotify_event) + event->len;
+
+            // Events were dropped: treat every file as changed, the cache sorts it out
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                listFiles("", changed);
+                continue;
+            }
+            if (event->mask & IN_IGNORED)
+            {
+                directories.erase(event->wd);
+                continue;
+            }
+
+            auto directory = directories.find(event->wd);
+            if (directory == directories.end() || event->len == 0)
+                continue;
+
+            string name = event->name;
+            string relative = joinPath(directory->second, name);
+            if (event->mask & IN_ISDIR)
+            {
+                if (recursive && name[0] != '.' && (event->mask & (IN_CREATE | IN_MOVED_TO)))
+                    watchTree(relative, &changed);
+            }
+            else if ((event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) && isDefinitionFile(name))
+            {
+                changed.insert(relative);
+            }
+        }
+    }
+}
+
+// Block until definition files change and have been quiet for debounce
+bool DefinitionWatcher::waitForChanges(chrono::milliseconds debounce, vector<string> &changed, string &error)
+{
+    set<string> found;
+    int timeout = -1;
+    while (true)
+    {
+        struct pollfd poller = {fd, POLLIN, 0};
+        int ready = poll(&poller, 1, timeout);
+        if (ready < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            error = string("Could not wait for file events: ") + strerror(errno);
+            return false;
+        }
+
+        // Quiet for a whole debounce period
+        if (ready == 0)
+            break;
+
+        if (!readEvents(found, error))
+            return false;
+
+        // Only definition files start the countdown
+        if (!found.empty())
+            timeout = static_cast<int>(debounce.count());
+    }
+
+    changed.assign(found.begin(), found.end());
+    return true;
+}
+
+#else
+
+DefinitionWatcher::~DefinitionWatcher()
+{
+}
+
+bool DefinitionWatcher::start(const string &, bool, string &error)
+{
+    error = "--watch needs inotify, which is only available on Linux.";
+    return false;
+}
+
+bool DefinitionWatcher::waitForChanges(chrono::milliseconds, vector<string> &, string &error)
+{
+    error = "--watch needs inotify, which is only available on Linux.";
+    return false;
+}
+
+#endif
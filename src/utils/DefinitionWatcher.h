@@ -0,0 +1,51 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#ifndef DEFINITION_WATCHER_H
+#define DEFINITION_WATCHER_H
+
+#include <chrono>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// Reports definition files that were written or moved into a directory,
+// using inotify. With recursive, subdirectories are watched too, including
+// ones created later (hidden directories are skipped, as in the scan).
+// Deleted files are not reported. Linux only: elsewhere start() fails.
+class DefinitionWatcher
+{
+public:
+    DefinitionWatcher() = default;
+    ~DefinitionWatcher();
+
+    DefinitionWatcher(const DefinitionWatcher &) = delete;
+    DefinitionWatcher &operator=(const DefinitionWatcher &) = delete;
+
+    bool start(const string &root, bool recursive, string &error);
+
+    // Block until definition files change, then until no more changes come
+    // for debounce, so a burst of saves is handled once. changed gets the
+    // paths relative to the root, sorted. False if watching fails.
+    bool waitForChanges(chrono::milliseconds debounce, vector<string> &changed, string &error);
+
+private:
+    void watchTree(const string &relative, set<string> *existingFiles);
+    bool readEvents(set<string> &changed, string &error);
+    void listFiles(const string &relative, set<string> &files);
+
+    int fd = -1;
+    string rootPath;
+    bool recursive = false;
+    unordered_map<int, string> directories; // Watch descriptor -> path relative to the root
+};
+
+#endif
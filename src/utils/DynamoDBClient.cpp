@@ -0,0 +1,158 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#include <rapidjson/document.h>
+#include "DynamoDBClient.h"
+#include "AwsCliClient.h"
+#include "HttpDynamoDBClient.h"
+
+using namespace rapidjson;
+
+static unique_ptr<DynamoDBClient> activeClient;
+
+// Run one request on a private loop and wait for its result
+DynamoResult DynamoDBClient::call(const DynamoRequest &request)
+{
+    EventLoop loop;
+    DynamoResult result;
+    submit(loop, request, [&](DynamoResult finished)
+           {
+               result = std::move(finished);
+               loop.stop(); });
+    loop.run();
+    return result;
+}
+
+DynamoResult DynamoDBClient::listTables(const string &startToken)
+{
+    return call({DynamoOperation::ListTables, "", "", startToken});
+}
+
+DynamoResult DynamoDBClient::describeTable(const string &tableName)
+{
+    return call({DynamoOperation::DescribeTable, tableName, "", ""});
+}
+
+DynamoResult DynamoDBClient::createTable(const string &requestJson)
+{
+    return call({DynamoOperation::CreateTable, "", requestJson, ""});
+}
+
+DynamoResult DynamoDBClient::deleteTable(const string &tableName)
+{
+    return call({DynamoOperation::DeleteTable, tableName, "", ""});
+}
+
+void DynamoCall::await_suspend(coroutine_handle<> waiting)
+{
+    DynamoResult *destination = &result;
+    dynamoClient().submit(loop, request, [destination, waiting](DynamoResult finished)
+                          {
+                              *destination = std::move(finished);
+                              waiting.resume(); });
+}
+
+// How a failed call should be handled
+DynamoErrorClass classifyDynamoError(const DynamoResult &result)
+{
+    if (result.ok())
+        return DynamoErrorClass::None;
+
+    const string &type = result.errorType;
+    if (type == "ThrottlingException" || type == "ProvisionedThroughputExceededException" || type == "RequestLimitExceeded")
+        return DynamoErrorClass::Throttled;
+    if (type == "LimitExceededException")
+        return DynamoErrorClass::LimitExceeded;
+    if (type == "ResourceInUseException")
+        return DynamoErrorClass::ResourceInUse;
+    if (type == "ResourceNotFoundException")
+        return DynamoErrorClass::NotFound;
+
+    // A failure with no service error type is only worth retrying when the
+    // request never got an answer; a CLI that failed on its own (bad
+    // parameters, no credentials, not installed) fails the same way again
+    if (result.noResponse || result.httpStatus >= 500 || type == "InternalServerError" || type == "ServiceUnavailable")
+        return DynamoErrorClass::Transient;
+    return DynamoErrorClass::Fatal;
+}
+
+// Fill the decoded fields of a successful result from its body
+bool decodeDynamoResult(DynamoOperation operation, const char *nextTokenField, DynamoResult &result)
+{
+    if (operation == DynamoOperation::CreateTable && result.body.empty())
+        return true;
+
+    Document response;
+    response.Parse(result.body.c_str());
+    if (response.HasParseError() || !response.IsObject())
+    {
+        result.success = false;
+        result.message = "Unexpected response: " + result.body;
+        return false;
+    }
+
+    switch (operation)
+    {
+    case DynamoOperation::ListTables:
+        if (!response.HasMember("TableNames") || !response["TableNames"].IsArray())
+        {
+            result.success = false;
+            result.message = "Unexpected ListTables response.";
+            return false;
+        }
+        for (const auto &name : response["TableNames"].GetArray())
+        {
+            if (name.IsString())
+                result.tableNames.emplace_back(name.GetString(), name.GetStringLength());
+        }
+        if (response.HasMember(nextTokenField) && response[nextTokenField].IsString())
+            result.nextToken = response[nextTokenField].GetString();
+        break;
+
+    case DynamoOperation::DescribeTable:
+    case DynamoOperation::CreateTable:
+    case DynamoOperation::DeleteTable:
+    {
+        const char *wrapper = operation == DynamoOperation::DescribeTable ? "Table" : "TableDescription";
+        if (response.HasMember(wrapper) && response[wrapper].IsObject())
+        {
+            const Value &table = response[wrapper];
+            if (table.HasMember("TableStatus") && table["TableStatus"].IsString())
+                result.tableStatus = table["TableStatus"].GetString();
+        }
+        break;
+    }
+    }
+
+    return true;
+}
+
+// Select the backend for this run
+bool initDynamoDBClient(const string &endpointUrl, string &error)
+{
+    if (endpointUrl.compare(0, 7, "http://") == 0)
+    {
+        HttpEndpoint endpoint;
+        if (!parseHttpEndpoint(endpointUrl, endpoint, error))
+            return false;
+        activeClient.reset(new HttpDynamoDBClient(endpointUrl, endpoint));
+    }
+    else
+    {
+        activeClient.reset(new AwsCliClient(endpointUrl));
+    }
+    return true;
+}
+
+// The client chosen by initDynamoDBClient()
+DynamoDBClient &dynamoClient()
+{
+    if (!activeClient)
+        activeClient.reset(new AwsCliClient(""));
+    return *activeClient;
+}
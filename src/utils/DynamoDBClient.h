@@ -0,0 +1,131 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#ifndef DYNAMODB_CLIENT_H
+#define DYNAMODB_CLIENT_H
+
+#include <coroutine>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "EventLoop.h"
+
+using namespace std;
+
+enum class DynamoOperation
+{
+    ListTables,
+    DescribeTable,
+    CreateTable,
+    DeleteTable
+};
+
+struct DynamoRequest
+{
+    DynamoOperation operation;
+    string tableName;   // DescribeTable, DeleteTable
+    string requestJson; // CreateTable: a complete CreateTable input document
+    string startToken;  // ListTables: empty for the first page
+};
+
+// Outcome of one DynamoDB control-plane call
+struct DynamoResult
+{
+    bool success = false;
+    string errorType; // Short exception name, e.g. "ResourceNotFoundException"
+    string message;   // Human readable error text
+    string body;      // Response JSON on success
+    bool noResponse = false; // The request never got an answer: connection, DNS or timeout failure
+    int httpStatus = 0;      // Built-in client: the HTTP status, when a response arrived
+
+    // Decoded from the response where the operation returns them
+    vector<string> tableNames; // ListTables
+    string nextToken;          // ListTables: empty after the last page
+    string tableStatus;        // DescribeTable, CreateTable, DeleteTable
+
+    bool ok() const { return success; }
+};
+
+using DynamoCallback = function<void(DynamoResult)>;
+
+// How a failed call should be handled
+enum class DynamoErrorClass
+{
+    None,          // The call succeeded
+    Throttled,     // ThrottlingException, ProvisionedThroughputExceededException, RequestLimitExceeded
+    LimitExceeded, // LimitExceededException: too many tables in CREATING/UPDATING/DELETING
+    ResourceInUse, // ResourceInUseException: the table exists or is changing state
+    NotFound,      // ResourceNotFoundException
+    Transient,     // No response, or a 5xx service error
+    Fatal          // Validation, access, local CLI failures and every other error
+};
+
+DynamoErrorClass classifyDynamoError(const DynamoResult &result);
+
+// The control-plane operations the tool needs. Implemented by the AWS CLI
+// backend and by the built-in HTTP client. Calls are asynchronous on an
+// EventLoop; the blocking helpers run a private loop until the call is done.
+class DynamoDBClient
+{
+public:
+    virtual ~DynamoDBClient() = default;
+
+    // Start request on loop; done runs on the loop thread
+    virtual void submit(EventLoop &loop, const DynamoRequest &request, DynamoCallback done) = 0;
+
+    // Short description for logs, e.g. "AWS CLI" or "http://localhost:8000"
+    virtual string description() const = 0;
+
+    // Blocking helpers
+    DynamoResult call(const DynamoRequest &request);
+    DynamoResult listTables(const string &startToken);
+    DynamoResult describeTable(const string &tableName);
+    DynamoResult createTable(const string &requestJson);
+    DynamoResult deleteTable(const string &tableName);
+};
+
+// co_await dynamoCall(loop, request) submits request through the active
+// client and resumes the coroutine with its result. Pass a named request:
+// GCC 12 double-destroys braced temporaries inside co_await expressions.
+class DynamoCall
+{
+public:
+    DynamoCall(EventLoop &loop, const DynamoRequest &request) : loop(loop), request(request) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    // The callback may resume the coroutine before submit() returns, so
+    // nothing here may touch the awaiter after submitting
+    void await_suspend(coroutine_handle<> waiting);
+
+    DynamoResult await_resume() { return std::move(result); }
+
+private:
+    EventLoop &loop;
+    DynamoRequest request;
+    DynamoResult result;
+};
+
+inline DynamoCall dynamoCall(EventLoop &loop, const DynamoRequest &request)
+{
+    return DynamoCall(loop, request);
+}
+
+// Fill tableNames/nextToken/tableStatus of a successful result from its body.
+// nextTokenField is "NextToken" for the CLI, "LastEvaluatedTableName" for the API.
+bool decodeDynamoResult(DynamoOperation operation, const char *nextTokenField, DynamoResult &result);
+
+// Select the backend for this run: the built-in client for http:// endpoints,
+// the AWS CLI (with --endpoint-url passed through, if any) otherwise.
+bool initDynamoDBClient(const string &endpointUrl, string &error);
+
+// The client chosen by initDynamoDBClient()
+DynamoDBClient &dynamoClient();
+
+#endif
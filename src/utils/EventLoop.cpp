@@ -0,0 +1,287 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include "EventLoop.h"
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#else
+#include <poll.h>
+#endif
+
+namespace
+{
+    void setNonBlocking(int fd)
+    {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+
+#ifdef __linux__
+    uint32_t toEpoll(uint32_t events)
+    {
+        uint32_t flags = 0;
+        if (events & EventLoop::Readable)
+            flags |= EPOLLIN;
+        if (events & EventLoop::Writable)
+            flags |= EPOLLOUT;
+        return flags;
+    }
+
+    uint32_t fromEpoll(uint32_t flags)
+    {
+        uint32_t events = 0;
+        if (flags & EPOLLIN)
+            events |= EventLoop::Readable;
+        if (flags & EPOLLOUT)
+            events |= EventLoop::Writable;
+        if (flags & (EPOLLERR | EPOLLHUP))
+            events |= EventLoop::Failed;
+        return events;
+    }
+#endif
+}
+
+EventLoop::EventLoop()
+{
+#ifdef __linux__
+    backendFd = epoll_create1(EPOLL_CLOEXEC);
+#endif
+
+    // Self-pipe so post() can wake a loop blocked in wait()
+    if (pipe(wakeFds) == 0)
+    {
+        setNonBlocking(wakeFds[0]);
+        setNonBlocking(wakeFds[1]);
+        watch(wakeFds[0], Readable, [this](uint32_t)
+              {
+                  char drain[64];
+                  while (read(wakeFds[0], drain, sizeof(drain)) > 0)
+                      ;
+              });
+    }
+}
+
+EventLoop::~EventLoop()
+{
+    if (wakeFds[0] >= 0)
+    {
+        close(wakeFds[0]);
+        close(wakeFds[1]);
+    }
+    if (backendFd >= 0)
+        close(backendFd);
+}
+
+// Start watching a non-blocking file descriptor
+void EventLoop::watch(int fd, uint32_t events, IoCallback callback)
+{
+    uint32_t generation = nextGeneration++;
+    watches[fd] = {events, generation, make_shared<IoCallback>(std::move(callback))};
+
+#ifdef __linux__
+    epoll_event event = {};
+    event.events = toEpoll(events);
+    event.data.u64 = (static_cast<uint64_t>(generation) << 32) | static_cast<uint32_t>(fd);
+    if (epoll_ctl(backendFd, EPOLL_CTL_ADD, fd, &event) != 0 && errno == EEXIST)
+        epoll_ctl(backendFd, EPOLL_CTL_MOD, fd, &event);
+#endif
+}
+
+// Change the events a watched descriptor is interested in
+void EventLoop::modify(int fd, uint32_t events)
+{
+    auto watched = watches.find(fd);
+    if (watched == watches.end() || watched->second.events == events)
+        return;
+    watched->second.events = events;
+
+#ifdef __linux__
+    epoll_event event = {};
+    event.events = toEpoll(events);
+    event.data.u64 = (static_cast<uint64_t>(watched->second.generation) << 32) | static_cast<uint32_t>(fd);
+    epoll_ctl(backendFd, EPOLL_CTL_MOD, fd, &event);
+#endif
+}
+
+// Stop watching a descriptor; call before closing it
+void EventLoop::unwatch(int fd)
+{
+    if (watches.erase(fd) == 0)
+        return;
+
+#ifdef __linux__
+    epoll_ctl(backendFd, EPOLL_CTL_DEL, fd, nullptr);
+#endif
+}
+
+// Run callback once after delay
+EventLoop::TimerId EventLoop::runAfter(chrono::milliseconds delay, Callback callback)
+{
+    TimerId id = nextTimerId++;
+    Clock::time_point deadline = Clock::now() + delay;
+    timers.emplace(make_pair(deadline, id), std::move(callback));
+    timerDeadlines[id] = deadline;
+    return id;
+}
+
+// Drop a timer that has not fired yet
+void EventLoop::cancel(TimerId timer)
+{
+    auto deadline = timerDeadlines.find(timer);
+    if (deadline == timerDeadlines.end())
+        return;
+
+    timers.erase(make_pair(deadline->second, timer));
+    timerDeadlines.erase(deadline);
+}
+
+// Queue callback to run on the loop thread
+void EventLoop::post(Callback callback)
+{
+    {
+        lock_guard<mutex> lock(postedMutex);
+        posted.push_back(std::move(callback));
+    }
+
+    char wake = 1;
+    ssize_t ignored = write(wakeFds[1], &wake, 1);
+    (void)ignored;
+}
+
+// Dispatch events until stop() is called
+void EventLoop::run()
+{
+    while (!stopping)
+    {
+        runPosted();
+        if (stopping)
+            break;
+
+        wait(nextTimeoutMs());
+        runExpiredTimers();
+    }
+
+    // The stop is used up, so the loop can run again
+    stopping = false;
+}
+
+void EventLoop::stop()
+{
+    stopping = true;
+}
+
+// Milliseconds until the next timer, 0 with posted work, -1 for none
+int EventLoop::nextTimeoutMs() const
+{
+    {
+        lock_guard<mutex> lock(postedMutex);
+        if (!posted.empty())
+            return 0;
+    }
+
+    if (timers.empty())
+        return -1;
+
+    auto remaining = chrono::duration_cast<chrono::milliseconds>(timers.begin()->first.first - Clock::now()).count();
+    if (remaining <= 0)
+        return 0;
+    // Round up so the timer is due when we wake
+    return static_cast<int>(remaining) + 1;
+}
+
+void EventLoop::runExpiredTimers()
+{
+    Clock::time_point now = Clock::now();
+    while (!timers.empty() && timers.begin()->first.first <= now)
+    {
+        Callback callback = std::move(timers.begin()->second);
+        timerDeadlines.erase(timers.begin()->first.second);
+        timers.erase(timers.begin());
+        callback();
+    }
+}
+
+void EventLoop::runPosted()
+{
+    vector<Callback> ready;
+    {
+        lock_guard<mutex> lock(postedMutex);
+        ready.swap(posted);
+    }
+
+    for (auto &callback : ready)
+        callback();
+}
+
+// Block until a watched descriptor is ready or the timeout passes, then
+// dispatch readiness callbacks
+void EventLoop::wait(int timeoutMs)
+{
+    struct Ready
+    {
+        int fd;
+        uint32_t generation;
+        uint32_t events;
+    };
+    vector<Ready> ready;
+
+#ifdef __linux__
+    epoll_event events[256];
+    int count = epoll_wait(backendFd, events, 256, timeoutMs);
+    for (int i = 0; i < count; ++i)
+    {
+        int fd = static_cast<int>(events[i].data.u64 & 0xffffffffu);
+        uint32_t generation = static_cast<uint32_t>(events[i].data.u64 >> 32);
+        ready.push_back({fd, generation, fromEpoll(events[i].events)});
+    }
+#else
+    vector<pollfd> fds;
+    fds.reserve(watches.size());
+    for (const auto &watched : watches)
+    {
+        short flags = 0;
+        if (watched.second.events & Readable)
+            flags |= POLLIN;
+        if (watched.second.events & Writable)
+            flags |= POLLOUT;
+        fds.push_back({watched.first, flags, 0});
+    }
+
+    if (poll(fds.data(), fds.size(), timeoutMs) > 0)
+    {
+        for (const auto &fd : fds)
+        {
+            uint32_t events = 0;
+            if (fd.revents & POLLIN)
+                events |= Readable;
+            if (fd.revents & POLLOUT)
+                events |= Writable;
+            if (fd.revents & (POLLERR | POLLHUP | POLLNVAL))
+                events |= Failed;
+            if (events != 0)
+                ready.push_back({fd.fd, watches[fd.fd].generation, events});
+        }
+    }
+#endif
+
+    for (const auto &event : ready)
+    {
+        // A previous callback in this batch may have unwatched the descriptor,
+        // or closed it and watched a new one under the same number
+        auto watched = watches.find(event.fd);
+        if (watched == watches.end() || watched->second.generation != event.generation)
+            continue;
+
+        shared_ptr<IoCallback> callback = watched->second.callback;
+        (*callback)(event.events);
+    }
+}
@@ -0,0 +1,91 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// Single-threaded I/O loop: readiness callbacks for file descriptors (epoll on
+// Linux, poll elsewhere), one-shot timers, and tasks posted from any thread.
+// Everything except post() must be called on the thread running run().
+class EventLoop
+{
+public:
+    using Callback = function<void()>;
+    using IoCallback = function<void(uint32_t events)>;
+    using TimerId = uint64_t;
+
+    // Readiness flags passed to watch() and reported to IoCallback
+    static const uint32_t Readable = 1;
+    static const uint32_t Writable = 2;
+    static const uint32_t Failed = 4; // Error or hang-up, always reported
+
+    EventLoop();
+    ~EventLoop();
+
+    EventLoop(const EventLoop &) = delete;
+    EventLoop &operator=(const EventLoop &) = delete;
+
+    // Start, change or stop watching a non-blocking file descriptor
+    void watch(int fd, uint32_t events, IoCallback callback);
+    void modify(int fd, uint32_t events);
+    void unwatch(int fd);
+
+    // Run callback once after delay; cancel() before it fires to drop it
+    TimerId runAfter(chrono::milliseconds delay, Callback callback);
+    void cancel(TimerId timer);
+
+    // Queue callback to run on the loop thread; safe from any thread
+    void post(Callback callback);
+
+    // Dispatch events until stop() is called. A stop() made before run()
+    // makes the next run() return at once; each run() uses up one stop.
+    void run();
+    void stop();
+
+private:
+    struct Watch
+    {
+        uint32_t events;
+        uint32_t generation; // Tells a reused descriptor number from its predecessor
+        shared_ptr<IoCallback> callback;
+    };
+
+    int nextTimeoutMs() const;
+    void runExpiredTimers();
+    void runPosted();
+    void wait(int timeoutMs);
+
+    int backendFd = -1; // epoll instance on Linux
+    int wakeFds[2] = {-1, -1};
+    bool stopping = false;
+
+    unordered_map<int, Watch> watches;
+    uint32_t nextGeneration = 1;
+
+    using Clock = chrono::steady_clock;
+    map<pair<Clock::time_point, TimerId>, Callback> timers;
+    unordered_map<TimerId, Clock::time_point> timerDeadlines;
+    TimerId nextTimerId = 1;
+
+    mutable mutex postedMutex;
+    vector<Callback> posted;
+};
+
+#endif
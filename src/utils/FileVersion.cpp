@@ -0,0 +1,28 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#include <sys/stat.h>
+#include "FileVersion.h"
+
+bool fingerprintFile(const string &path, FileFingerprint &fingerprint)
+{
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0)
+        return false;
+
+    fingerprint.inode = static_cast<unsigned long long>(info.st_ino);
+    fingerprint.size = static_cast<unsigned long long>(info.st_size);
+#if defined(__linux__)
+    fingerprint.mtimeNs = static_cast<long long>(info.st_mtim.tv_sec) * 1000000000LL + info.st_mtim.tv_nsec;
+#elif defined(__APPLE__)
+    fingerprint.mtimeNs = static_cast<long long>(info.st_mtimespec.tv_sec) * 1000000000LL + info.st_mtimespec.tv_nsec;
+#else
+    fingerprint.mtimeNs = static_cast<long long>(info.st_mtime) * 1000000000LL;
+#endif
+    return true;
+}
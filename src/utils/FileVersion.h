@@ -0,0 +1,41 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#ifndef FILE_VERSION_H
+#define FILE_VERSION_H
+
+#include <string>
+
+using namespace std;
+
+// Cheap identity of a file's current contents
+struct FileFingerprint
+{
+    unsigned long long inode = 0;
+    unsigned long long size = 0;
+    long long mtimeNs = 0;
+
+    bool operator==(const FileFingerprint &other) const
+    {
+        return inode == other.inode && size == other.size && mtimeNs == other.mtimeNs;
+    }
+};
+
+bool fingerprintFile(const string &path, FileFingerprint &fingerprint);
+
+// A definition file as pre-flight read it: the fingerprint taken just
+// before the read and a hex SHA-256 of the bytes that were read. An edit
+// saved later changes the fingerprint and the hash, so the cache never
+// mistakes it for what was applied.
+struct FileVersion
+{
+    FileFingerprint fingerprint;
+    string hash; // Empty until the bytes are hashed
+};
+
+#endif
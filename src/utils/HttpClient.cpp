@@ -0,0 +1,780 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <mutex>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "HttpClient.h"
+#include "TableMigrationTool.h"
+#include "spdlog/spdlog.h"
+
+// A send() on a socket the server has closed must fail with EPIPE, not
+// raise SIGPIPE: Linux takes MSG_NOSIGNAL per call, macOS and the BSDs
+// take SO_NOSIGPIPE per socket
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace
+{
+    const auto requestTimeout = chrono::seconds(30);
+
+    // Idle connections older than this are closed rather than reused; servers
+    // commonly drop keep-alive connections after a few tens of seconds.
+    const auto maxIdleTime = chrono::seconds(20);
+
+    // Incremental HTTP/1.1 response parser
+    class ResponseParser
+    {
+    public:
+        HttpResponse response;
+        bool keepAlive = true;
+
+        // Returns 1 when the response is complete, 0 when more data is needed
+        // and -1 when it is malformed
+        int feed(const char *data, size_t size)
+        {
+            raw.append(data, size);
+
+            if (headerEnd == string::npos)
+            {
+                headerEnd = raw.find("\r\n\r\n");
+                if (headerEnd == string::npos)
+                    return 0;
+                if (!parseHead())
+                    return -1;
+            }
+
+            if (chunked)
+                return decodeChunked();
+
+            if (hasLength && raw.size() >= contentLength)
+            {
+                response.body = raw.substr(0, contentLength);
+                return 1;
+            }
+            return 0;
+        }
+
+        // The server closed the connection; without a length the body runs
+        // until then
+        int finishOnEof()
+        {
+            keepAlive = false;
+            if (headerEnd != string::npos && !chunked && !hasLength)
+            {
+                response.body = std::move(raw);
+                return 1;
+            }
+            return -1;
+        }
+
+        bool started() const { return !raw.empty() || headerEnd != string::npos; }
+
+    private:
+        bool parseHead()
+        {
+            if (raw.compare(0, 5, "HTTP/") != 0)
+            {
+                response.error = "Malformed HTTP response";
+                return false;
+            }
+
+            response.status = atoi(raw.c_str() + raw.find(' ') + 1);
+            string head = raw.substr(0, headerEnd + 2);
+            for (auto &c : head)
+                c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+
+            chunked = head.find("\r\ntransfer-encoding: chunked") != string::npos;
+            size_t length = head.find("\r\ncontent-length:");
+            if (length != string::npos)
+            {
+                hasLength = true;
+                contentLength = strtoul(head.c_str() + length + 17, nullptr, 10);
+            }
+            if (head.find("\r\nconnection: close") != string::npos || head.compare(0, 8, "http/1.0") == 0)
+                keepAlive = false;
+
+            raw.erase(0, headerEnd + 4);
+            return true;
+        }
+
+        // Decode a chunked transfer-encoded body
+        int decodeChunked()
+        {
+            string decoded;
+            size_t position = 0;
+            while (true)
+            {
+                size_t lineEnd = raw.find("\r\n", position);
+                if (lineEnd == string::npos)
+                    return 0;
+
+                char *end = nullptr;
+                size_t chunkSize = strtoul(raw.c_str() + position, &end, 16);
+                if (end == raw.c_str() + position)
+                {
+                    response.error = "Malformed chunked response";
+                    return -1;
+                }
+                position = lineEnd + 2;
+
+                if (chunkSize == 0)
+                {
+                    // Skip optional trailers up to the final empty line
+                    if (raw.find("\r\n", position) == string::npos)
+                        return 0;
+                    response.body = std::move(decoded);
+                    return 1;
+                }
+                if (position + chunkSize + 2 > raw.size())
+                    return 0;
+
+                decoded.append(raw, position, chunkSize);
+                position += chunkSize + 2;
+            }
+        }
+
+        string raw;
+        size_t headerEnd = string::npos;
+        bool chunked = false;
+        bool hasLength = false;
+        size_t contentLength = 0;
+    };
+
+    // Idle connections, in-flight accounting and resolved addresses for one host:port
+    struct EndpointConnections
+    {
+        struct IdleConnection
+        {
+            int fd;
+            chrono::steady_clock::time_point since;
+        };
+
+        struct Waiter
+        {
+            EventLoop *loop;
+            EventLoop::Callback start;
+        };
+
+        struct ResolveWaiter
+        {
+            EventLoop *loop;
+            const void *owner; // The exchange, so it can withdraw if it ends first
+            EventLoop::Callback ready;
+        };
+
+        deque<IdleConnection> idle;
+        deque<Waiter> waiters;
+        size_t inFlight = 0;
+        vector<sockaddr_storage> addresses;
+        vector<socklen_t> addressLengths;
+        bool resolving = false;
+        string resolveError;          // Why the last lookup failed; failures aren't cached
+        vector<ResolveWaiter> resolveWaiters; // Exchanges waiting for the lookup in progress
+    };
+
+    // Process-wide keep-alive pool shared by every event loop and thread
+    class ConnectionPool
+    {
+    public:
+        ~ConnectionPool()
+        {
+            for (auto &resolver : resolvers)
+                resolver.join();
+            for (auto &entry : endpoints)
+                for (auto &connection : entry.second.idle)
+                    close(connection.fd);
+        }
+
+        // Take an in-flight slot, or queue start to run on loop once a slot
+        // is handed over. Returns true when the slot was taken immediately.
+        bool acquireSlot(const string &key, EventLoop &loop, EventLoop::Callback start)
+        {
+            lock_guard<mutex> lock(poolMutex);
+            EndpointConnections &connections = endpoints[key];
+            if (maxInFlight > 0 && connections.inFlight >= maxInFlight)
+            {
+                ++stats.waits;
+                connections.waiters.push_back({&loop, std::move(start)});
+                return false;
+            }
+
+            ++connections.inFlight;
+            if (connections.inFlight > stats.peakInFlight)
+                stats.peakInFlight = connections.inFlight;
+            return true;
+        }
+
+        // Give the slot to the next waiter, or free it
+        void releaseSlot(const string &key)
+        {
+            EndpointConnections::Waiter next = {nullptr, nullptr};
+            {
+                lock_guard<mutex> lock(poolMutex);
+                EndpointConnections &connections = endpoints[key];
+                if (connections.waiters.empty())
+                {
+                    --connections.inFlight;
+                    return;
+                }
+                next = std::move(connections.waiters.front());
+                connections.waiters.pop_front();
+            }
+            next.loop->post(std::move(next.start));
+        }
+
+        // Take a live idle connection, or -1 if there is none
+        int takeIdle(const string &key)
+        {
+            lock_guard<mutex> lock(poolMutex);
+            EndpointConnections &connections = endpoints[key];
+            auto now = chrono::steady_clock::now();
+
+            // Most recently used first, it is the least likely to have been dropped
+            while (!connections.idle.empty())
+            {
+                EndpointConnections::IdleConnection connection = connections.idle.back();
+                connections.idle.pop_back();
+
+                if (now - connection.since > maxIdleTime || !isAlive(connection.fd))
+                {
+                    ++stats.stale;
+                    close(connection.fd);
+                    continue;
+                }
+
+                ++stats.hits;
+                return connection.fd;
+            }
+
+            ++stats.misses;
+            return -1;
+        }
+
+        // Return a connection after a complete keep-alive exchange
+        void putIdle(const string &key, int fd)
+        {
+            lock_guard<mutex> lock(poolMutex);
+            EndpointConnections &connections = endpoints[key];
+
+            // Never keep more idle sockets than could ever be in flight at once
+            size_t idleLimit = maxInFlight > 0 ? maxInFlight : 64;
+            if (connections.idle.size() >= idleLimit)
+            {
+                close(fd);
+                return;
+            }
+            connections.idle.push_back({fd, chrono::steady_clock::now()});
+        }
+
+        // Resolve the endpoint once and reuse the addresses for every connection.
+        // The lookup runs on a thread of its own, so a slow or failing DNS
+        // server never blocks an event loop; ready is posted to loop when it
+        // is done, or called at once if the addresses are already known.
+        // Returns false when ready was queued.
+        bool resolve(const HttpEndpoint &endpoint, const string &key, EventLoop &loop, const void *owner, EventLoop::Callback ready)
+        {
+            {
+                lock_guard<mutex> lock(poolMutex);
+                EndpointConnections &connections = endpoints[key];
+                if (connections.addresses.empty())
+                {
+                    connections.resolveWaiters.push_back({&loop, owner, std::move(ready)});
+                    if (connections.resolving)
+                        return false;
+                    connections.resolving = true;
+                    resolvers.emplace_back([this, endpoint, key]
+                                           { lookup(endpoint, key); });
+                    return false;
+                }
+            }
+            ready();
+            return true;
+        }
+
+        // Drop a queued ready callback whose exchange has already ended;
+        // its loop may be gone by the time the lookup finishes
+        void cancelResolve(const string &key, const void *owner)
+        {
+            lock_guard<mutex> lock(poolMutex);
+            auto &waiters = endpoints[key].resolveWaiters;
+            waiters.erase(remove_if(waiters.begin(), waiters.end(), [owner](const EndpointConnections::ResolveWaiter &waiter)
+                                    { return waiter.owner == owner; }),
+                          waiters.end());
+        }
+
+        // The resolved addresses, or false with the reason the lookup failed
+        bool addresses(const string &key, vector<sockaddr_storage> &result, vector<socklen_t> &lengths, string &error)
+        {
+            lock_guard<mutex> lock(poolMutex);
+            EndpointConnections &connections = endpoints[key];
+            if (connections.addresses.empty())
+            {
+                error = connections.resolveError;
+                return false;
+            }
+            result = connections.addresses;
+            lengths = connections.addressLengths;
+            return true;
+        }
+
+        void countRetry()
+        {
+            lock_guard<mutex> lock(poolMutex);
+            ++stats.retries;
+        }
+
+        void setMaxInFlight(size_t limit)
+        {
+            lock_guard<mutex> lock(poolMutex);
+            maxInFlight = limit;
+        }
+
+        ConnectionPoolStats snapshot()
+        {
+            lock_guard<mutex> lock(poolMutex);
+            return stats;
+        }
+
+    private:
+        // Run getaddrinfo for resolve() and hand the outcome to every waiter
+        void lookup(const HttpEndpoint &endpoint, const string &key)
+        {
+            addrinfo hints = {};
+            hints.ai_family = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+
+            vector<sockaddr_storage> found;
+            vector<socklen_t> lengths;
+            string error;
+            addrinfo *list = nullptr;
+            int status = getaddrinfo(endpoint.host.c_str(), endpoint.port.c_str(), &hints, &list);
+            if (status != 0)
+                error = "Unable to resolve " + endpoint.host + ": " + gai_strerror(status);
+            for (addrinfo *address = list; address != nullptr; address = address->ai_next)
+            {
+                sockaddr_storage storage = {};
+                memcpy(&storage, address->ai_addr, address->ai_addrlen);
+                found.push_back(storage);
+                lengths.push_back(address->ai_addrlen);
+            }
+            if (list != nullptr)
+                freeaddrinfo(list);
+            if (status == 0 && found.empty())
+                error = "Unable to resolve " + endpoint.host + ": no addresses";
+
+            vector<EndpointConnections::ResolveWaiter> waiters;
+            {
+                lock_guard<mutex> lock(poolMutex);
+                EndpointConnections &connections = endpoints[key];
+                connections.addresses = std::move(found);
+                connections.addressLengths = std::move(lengths);
+                connections.resolveError = error;
+                connections.resolving = false;
+                waiters.swap(connections.resolveWaiters);
+            }
+            for (auto &waiter : waiters)
+                waiter.loop->post(std::move(waiter.ready));
+        }
+
+        // An idle keep-alive socket should have nothing to read; readable means
+        // the server closed it (EOF) or reset it.
+        static bool isAlive(int fd)
+        {
+            pollfd check = {fd, POLLIN, 0};
+            return poll(&check, 1, 0) == 0;
+        }
+
+        mutex poolMutex;
+        map<string, EndpointConnections> endpoints;
+        size_t maxInFlight = 64;
+        ConnectionPoolStats stats;
+        vector<thread> resolvers; // One per lookup, joined at exit
+    };
+
+    ConnectionPool pool;
+
+    // One request/response exchange driven by the event loop
+    class HttpExchange : public enable_shared_from_this<HttpExchange>
+    {
+    public:
+        HttpExchange(EventLoop &loop, const HttpEndpoint &endpoint, string request, function<void(HttpResponse)> done)
+            : loop(loop), endpoint(endpoint), key(endpoint.host + ":" + endpoint.port), request(std::move(request)),
+              done(std::move(done))
+        {
+        }
+
+        void start()
+        {
+            auto self = shared_from_this();
+            if (pool.acquireSlot(key, loop, [self]
+                                 { self->begin(); }))
+                begin();
+        }
+
+    private:
+        // Holding an in-flight slot: pick a connection and send
+        void begin()
+        {
+            auto self = shared_from_this();
+            timeout = loop.runAfter(requestTimeout, [self]
+                                    {
+                                        self->timeout = 0;
+                                        self->fail("Request timed out"); });
+
+            fd = pool.takeIdle(key);
+            reused = fd >= 0;
+            if (reused)
+            {
+                sendRequest();
+                return;
+            }
+
+            resolveAndConnect();
+        }
+
+        // Connect once the endpoint's addresses are known
+        void resolveAndConnect()
+        {
+            auto self = shared_from_this();
+            resolving = !pool.resolve(endpoint, key, loop, this, [self]
+                                      { self->onResolved(); });
+        }
+
+        void onResolved()
+        {
+            // The request may have timed out just as the lookup finished
+            resolving = false;
+            if (finished)
+                return;
+
+            string error;
+            if (!pool.addresses(key, addresses, addressLengths, error))
+            {
+                fail(error);
+                return;
+            }
+            connectNext();
+        }
+
+        // Start a non-blocking connect to the next resolved address
+        void connectNext()
+        {
+            while (addressIndex < addresses.size())
+            {
+                const sockaddr_storage &address = addresses[addressIndex];
+                socklen_t length = addressLengths[addressIndex];
+                ++addressIndex;
+
+                fd = socket(address.ss_family, SOCK_STREAM, 0);
+                if (fd < 0)
+                    continue;
+                fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+                fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+                int noDelay = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+#ifdef SO_NOSIGPIPE
+                int noSigpipe = 1;
+                setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &noSigpipe, sizeof(noSigpipe));
+#endif
+
+                if (connect(fd, reinterpret_cast<const sockaddr *>(&address), length) == 0)
+                {
+                    sendRequest();
+                    return;
+                }
+                if (errno == EINPROGRESS)
+                {
+                    auto self = shared_from_this();
+                    loop.watch(fd, EventLoop::Writable, [self](uint32_t)
+                               { self->onConnected(); });
+                    return;
+                }
+
+                connectError = strerror(errno);
+                close(fd);
+                fd = -1;
+            }
+
+            fail("Unable to connect to " + endpoint.hostHeader() + ": " + connectError);
+        }
+
+        void onConnected()
+        {
+            int error = 0;
+            socklen_t length = sizeof(error);
+            getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length);
+            loop.unwatch(fd);
+
+            if (error != 0)
+            {
+                connectError = strerror(error);
+                close(fd);
+                fd = -1;
+                connectNext();
+                return;
+            }
+            sendRequest();
+        }
+
+        void sendRequest()
+        {
+            auto self = shared_from_this();
+            loop.watch(fd, EventLoop::Writable | EventLoop::Readable, [self](uint32_t events)
+                       { self->onReady(events); });
+            onReady(EventLoop::Writable);
+        }
+
+        void onReady(uint32_t events)
+        {
+            if (sent < request.size() && (events & (EventLoop::Writable | EventLoop::Failed)))
+            {
+                while (sent < request.size())
+                {
+                    ssize_t count = send(fd, request.data() + sent, request.size() - sent, MSG_NOSIGNAL);
+                    if (count > 0)
+                    {
+                        sent += static_cast<size_t>(count);
+                        continue;
+                    }
+                    if (count < 0 && errno == EINTR)
+                        continue;
+                    if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                        return;
+
+                    retryOrFail(string("Unable to send request: ") + strerror(errno));
+                    return;
+                }
+                loop.modify(fd, EventLoop::Readable);
+            }
+
+            if (events & (EventLoop::Readable | EventLoop::Failed))
+                receive();
+        }
+
+        void receive()
+        {
+            char buffer[16384];
+            while (true)
+            {
+                ssize_t count = recv(fd, buffer, sizeof(buffer), 0);
+                if (count > 0)
+                {
+                    int state = parser.feed(buffer, static_cast<size_t>(count));
+                    if (state != 0)
+                    {
+                        complete(state > 0);
+                        return;
+                    }
+                    continue;
+                }
+                if (count < 0 && errno == EINTR)
+                    continue;
+                if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                    return;
+
+                if (count == 0 && parser.finishOnEof() > 0)
+                {
+                    complete(true);
+                    return;
+                }
+                retryOrFail(count == 0 ? "Connection closed before the response was complete"
+                                       : string("Unable to read response: ") + strerror(errno));
+                return;
+            }
+        }
+
+        // The server may have closed a reused connection just as we sent on
+        // it; that is safe to retry once on a fresh connection
+        void retryOrFail(const string &error)
+        {
+            if (!reused || parser.started())
+            {
+                fail(error);
+                return;
+            }
+
+            pool.countRetry();
+            loop.unwatch(fd);
+            close(fd);
+            fd = -1;
+            reused = false;
+            sent = 0;
+            resolveAndConnect();
+        }
+
+        void complete(bool parsed)
+        {
+            loop.unwatch(fd);
+            if (parsed && parser.keepAlive)
+                pool.putIdle(key, fd);
+            else
+                close(fd);
+            fd = -1;
+
+            HttpResponse response = std::move(parser.response);
+            if (!parsed && response.error.empty())
+                response.error = "Malformed HTTP response";
+            finish(std::move(response));
+        }
+
+        // A failure can be found before the caller runs the loop, e.g. when
+        // every connect is refused at once, so it is delivered through the
+        // loop as runCommandAsync does
+        void fail(const string &error)
+        {
+            if (fd >= 0)
+            {
+                loop.unwatch(fd);
+                close(fd);
+                fd = -1;
+            }
+
+            HttpResponse response;
+            response.error = error;
+            finish(std::move(response), true);
+        }
+
+        void finish(HttpResponse response, bool deferred = false)
+        {
+            if (finished)
+                return;
+            finished = true;
+
+            if (timeout != 0)
+                loop.cancel(timeout);
+            if (resolving)
+                pool.cancelResolve(key, this);
+            pool.releaseSlot(key);
+
+            DEBUG_LOG("HTTP POST " << endpoint.hostHeader() << " -> " << response.status);
+            if (!deferred)
+            {
+                done(std::move(response));
+                return;
+            }
+
+            auto self = shared_from_this();
+            auto result = make_shared<HttpResponse>(std::move(response));
+            loop.post([self, result]
+                      { self->done(std::move(*result)); });
+        }
+
+        EventLoop &loop;
+        HttpEndpoint endpoint;
+        string key;
+        string request;
+        function<void(HttpResponse)> done;
+
+        int fd = -1;
+        bool reused = false;
+        bool finished = false;
+        bool resolving = false; // Queued for the endpoint's name lookup
+        size_t sent = 0;
+        ResponseParser parser;
+        EventLoop::TimerId timeout = 0;
+
+        vector<sockaddr_storage> addresses;
+        vector<socklen_t> addressLengths;
+        size_t addressIndex = 0;
+        string connectError = "no usable address";
+    };
+}
+
+// Parse an http:// URL
+bool parseHttpEndpoint(const string &url, HttpEndpoint &endpoint, string &error)
+{
+    const string scheme = "http://";
+    if (url.compare(0, scheme.size(), scheme) != 0)
+    {
+        error = "Only http:// endpoints are supported by the built-in client: " + url;
+        return false;
+    }
+
+    string rest = url.substr(scheme.size());
+    size_t slash = rest.find('/');
+    string authority = rest.substr(0, slash);
+    endpoint.path = slash == string::npos ? "/" : rest.substr(slash);
+
+    size_t colon = authority.rfind(':');
+    if (colon != string::npos && authority.find(']', colon) == string::npos)
+    {
+        endpoint.host = authority.substr(0, colon);
+        endpoint.port = authority.substr(colon + 1);
+    }
+    else
+    {
+        endpoint.host = authority;
+    }
+
+    // Strip brackets from IPv6 literals for getaddrinfo
+    if (endpoint.host.size() > 2 && endpoint.host.front() == '[' && endpoint.host.back() == ']')
+        endpoint.host = endpoint.host.substr(1, endpoint.host.size() - 2);
+
+    if (endpoint.host.empty() || endpoint.port.empty())
+    {
+        error = "Invalid endpoint URL: " + url;
+        return false;
+    }
+    return true;
+}
+
+// Send one HTTP/1.1 POST on the event loop
+void httpPostAsync(EventLoop &loop, const HttpEndpoint &endpoint, const map<string, string> &headers, const string &body,
+                   function<void(HttpResponse)> done)
+{
+    string request = "POST " + endpoint.path + " HTTP/1.1\r\n";
+    for (const auto &header : headers)
+        request += header.first + ": " + header.second + "\r\n";
+    request += "content-length: " + to_string(body.size()) + "\r\n";
+    request += "connection: keep-alive\r\n\r\n";
+    request += body;
+
+    make_shared<HttpExchange>(loop, endpoint, std::move(request), std::move(done))->start();
+}
+
+// Cap the number of concurrent requests (and so connections) per endpoint
+void setMaxConnectionsPerEndpoint(size_t limit)
+{
+    pool.setMaxInFlight(limit);
+}
+
+ConnectionPoolStats connectionPoolStats()
+{
+    return pool.snapshot();
+}
+
+// Write the pool counters to the debug log
+void logConnectionPoolStats()
+{
+    ConnectionPoolStats stats = connectionPoolStats();
+    DEBUG_LOG("Connection pool: " << stats.hits << " hit(s), " << stats.misses << " miss(es), " << stats.stale
+                                  << " stale, " << stats.retries << " retry(ies), " << stats.waits
+                                  << " wait(s), peak in-flight " << stats.peakInFlight);
+    auto fileLogger = spdlog::get("file_logger");
+    if (fileLogger)
+    {
+        fileLogger->debug("Connection pool: {} hit(s), {} miss(es), {} stale, {} retry(ies), {} wait(s), peak in-flight {}",
+                          stats.hits, stats.misses, stats.stale, stats.retries, stats.waits, stats.peakInFlight);
+    }
+}
@@ -0,0 +1,68 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#ifndef HTTP_CLIENT_H
+#define HTTP_CLIENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include "EventLoop.h"
+
+using namespace std;
+
+// Parsed http:// endpoint
+struct HttpEndpoint
+{
+    string host;
+    string port = "80";
+    string path = "/";
+
+    // Value for the Host header
+    string hostHeader() const { return port == "80" ? host : host + ":" + port; }
+};
+
+struct HttpResponse
+{
+    int status = 0;
+    string body;
+    string error; // Set when the request failed below HTTP (connect, send, receive)
+};
+
+// Parse an http:// URL. Returns false with a message in error for anything
+// else, including https:// which this client does not speak.
+bool parseHttpEndpoint(const string &url, HttpEndpoint &endpoint, string &error);
+
+// Send one HTTP/1.1 POST on the event loop and call done with the full
+// response. Connections are kept alive and reused through a process-wide
+// pool, and requests beyond the per-endpoint in-flight cap wait their turn.
+void httpPostAsync(EventLoop &loop, const HttpEndpoint &endpoint, const map<string, string> &headers, const string &body,
+                   function<void(HttpResponse)> done);
+
+// Counters of the keep-alive connection pool
+struct ConnectionPoolStats
+{
+    uint64_t hits = 0;        // Requests served on a reused connection
+    uint64_t misses = 0;      // Requests that had to open a new connection
+    uint64_t stale = 0;       // Idle connections found closed and discarded
+    uint64_t retries = 0;     // Requests resent after a reused connection failed
+    uint64_t waits = 0;       // Requests that waited for an in-flight slot
+    size_t peakInFlight = 0;  // Highest number of concurrent requests to one endpoint
+};
+
+// Cap the number of concurrent requests (and so connections) per endpoint
+void setMaxConnectionsPerEndpoint(size_t limit);
+
+ConnectionPoolStats connectionPoolStats();
+
+// Write the pool counters to the debug log
+void logConnectionPoolStats();
+
+#endif
@@ -0,0 +1,132 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#include <ctime>
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+#include "HttpDynamoDBClient.h"
+#include "TableMigrationTool.h"
+
+using namespace rapidjson;
+
+namespace
+{
+    // {"<key>": "<value>"}, or {} when value is empty
+    string singleStringBody(const char *key, const string &value)
+    {
+        StringBuffer buffer;
+        Writer<StringBuffer> writer(buffer);
+        writer.StartObject();
+        if (!value.empty())
+        {
+            writer.Key(key);
+            writer.String(value.c_str(), static_cast<SizeType>(value.size()));
+        }
+        writer.EndObject();
+        return string(buffer.GetString(), buffer.GetSize());
+    }
+
+    // Translate an HTTP response into a DynamoResult
+    DynamoResult toDynamoResult(DynamoOperation operation, const string &target, HttpResponse response)
+    {
+        DynamoResult result;
+        if (!response.error.empty())
+        {
+            result.message = response.error;
+            result.noResponse = true;
+            return result;
+        }
+
+        result.httpStatus = response.status;
+        result.success = response.status == 200;
+        if (result.success)
+        {
+            result.body = std::move(response.body);
+            decodeDynamoResult(operation, "LastEvaluatedTableName", result);
+            return result;
+        }
+
+        // Errors look like {"__type":"com.amazonaws.dynamodb.v20120810#ResourceNotFoundException","message":"..."}
+        Document error;
+        error.Parse(response.body.c_str());
+        if (!error.HasParseError() && error.IsObject())
+        {
+            if (error.HasMember("__type") && error["__type"].IsString())
+            {
+                string type = error["__type"].GetString();
+                size_t hash = type.rfind('#');
+                result.errorType = hash == string::npos ? type : type.substr(hash + 1);
+            }
+            for (const char *field : {"message", "Message"})
+            {
+                if (error.HasMember(field) && error[field].IsString())
+                    result.message = error[field].GetString();
+            }
+        }
+
+        if (result.message.empty())
+            result.message = "HTTP " + to_string(response.status) + " " + response.body;
+        if (!result.errorType.empty())
+            result.message = "An error occurred (" + result.errorType + ") when calling the " + target + " operation: " + result.message;
+        return result;
+    }
+}
+
+HttpDynamoDBClient::HttpDynamoDBClient(const string &endpointUrl, const HttpEndpoint &endpoint)
+    : endpointUrl(endpointUrl), endpoint(endpoint), credentials(loadAwsCredentials()), region(loadAwsRegion())
+{
+    // Local endpoints accept any key pair, so don't fail on a machine without credentials
+    if (credentials.accessKeyId.empty() || credentials.secretAccessKey.empty())
+    {
+        DEBUG_LOG("No AWS credentials found, signing with placeholder credentials.");
+        credentials.accessKeyId = "local";
+        credentials.secretAccessKey = "local";
+    }
+}
+
+// POST the request to the endpoint as DynamoDB_20120810.<operation>
+void HttpDynamoDBClient::submit(EventLoop &loop, const DynamoRequest &request, DynamoCallback done)
+{
+    string target;
+    string body;
+    switch (request.operation)
+    {
+    case DynamoOperation::ListTables:
+        target = "ListTables";
+        body = singleStringBody("ExclusiveStartTableName", request.startToken);
+        break;
+    case DynamoOperation::DescribeTable:
+        target = "DescribeTable";
+        body = singleStringBody("TableName", request.tableName);
+        break;
+    case DynamoOperation::CreateTable:
+        target = "CreateTable";
+        body = request.requestJson;
+        break;
+    case DynamoOperation::DeleteTable:
+        target = "DeleteTable";
+        body = singleStringBody("TableName", request.tableName);
+        break;
+    }
+
+    map<string, string> headers;
+    headers["host"] = endpoint.hostHeader();
+    headers["content-type"] = "application/x-amz-json-1.0";
+    headers["x-amz-target"] = "DynamoDB_20120810." + target;
+    signRequestV4(headers, "POST", endpoint.path, body, region, "dynamodb", credentials, time(nullptr));
+
+    DynamoOperation operation = request.operation;
+    httpPostAsync(loop, endpoint, headers, body, [operation, target, done](HttpResponse response)
+                  { done(toDynamoResult(operation, target, std::move(response))); });
+}
+
+string HttpDynamoDBClient::description() const
+{
+    return endpointUrl;
+}
@@ -0,0 +1,34 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#ifndef HTTP_DYNAMODB_CLIENT_H
+#define HTTP_DYNAMODB_CLIENT_H
+
+#include "DynamoDBClient.h"
+#include "HttpClient.h"
+#include "SigV4.h"
+
+// DynamoDB backend speaking the JSON 1.0 protocol directly over HTTP,
+// signed with SigV4
+class HttpDynamoDBClient : public DynamoDBClient
+{
+public:
+    HttpDynamoDBClient(const string &endpointUrl, const HttpEndpoint &endpoint);
+
+    void submit(EventLoop &loop, const DynamoRequest &request, DynamoCallback done) override;
+    string description() const override;
+
+private:
+
+    string endpointUrl;
+    HttpEndpoint endpoint;
+    AwsCredentials credentials;
+    string region;
+};
+
+#endif
@@ -0,0 +1,96 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "MappedFile.h"
+
+namespace
+{
+    atomic<bool> mappingAllowed{true};
+}
+
+void MappedFile::allowMapping(bool allowed)
+{
+    mappingAllowed = allowed;
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+void MappedFile::close()
+{
+    if (mappedLength != 0)
+        munmap(bytes, mappedLength);
+    bytes = nullptr;
+    length = 0;
+    mappedLength = 0;
+    buffer.clear();
+}
+
+bool MappedFile::open(const string &path, string &error)
+{
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        error = string("could not open the file: ") + strerror(errno);
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        error = string("could not stat the file: ") + strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    length = static_cast<size_t>(info.st_size);
+
+    // The rest of the last page reads as zeros, which terminates the text;
+    // a file that fills its last page exactly has no room for that
+    static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    if (mappingAllowed && length % pageSize != 0)
+    {
+        void *mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED)
+        {
+            ::close(fd);
+            bytes = static_cast<char *>(mapping);
+            mappedLength = length;
+            return true;
+        }
+    }
+
+    // A file cut short since the fstat() simply ends early
+    buffer.resize(length + 1);
+    size_t done = 0;
+    while (done < length)
+    {
+        ssize_t count = ::read(fd, buffer.data() + done, length - done);
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0)
+            break;
+        done += static_cast<size_t>(count);
+    }
+    ::close(fd);
+
+    length = done;
+    buffer[length] = '\0';
+    bytes = buffer.data();
+    return true;
+}
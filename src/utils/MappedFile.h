@@ -0,0 +1,50 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// A whole file in memory as a writable, NUL-terminated buffer, ready for
+// rapidjson's in-situ parsing. The file is mapped privately, so in-situ
+// writes never reach the disk and untouched pages are never read; when the
+// mapping has no spare byte for the terminator the file is read with a
+// single read() instead.
+class MappedFile
+{
+public:
+    // A mapped file that another process truncates raises SIGBUS on the
+    // next touch of a lost page. --watch reads files while editors save
+    // them, so it turns mapping off and every file is read into a buffer.
+    static void allowMapping(bool allowed);
+
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool open(const string &path, string &error);
+    void close();
+
+    char *data() { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    char *bytes = nullptr;
+    size_t length = 0;
+    size_t mappedLength = 0;
+    vector<char> buffer;
+};
+
+#endif
@@ -0,0 +1,48 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#include "ParseArena.h"
+
+namespace
+{
+    const size_t initialStackBytes = 16 * 1024;
+}
+
+ParseArena::ParseArena()
+{
+    stackPool.init(initialStackBytes, &base);
+}
+
+void ParseArena::Pool::init(size_t size, CountingAllocator *base)
+{
+    allocator.reset();
+    buffer.resize(size);
+    allocator.reset(new ArenaAllocator(buffer.data(), buffer.size(), RAPIDJSON_ALLOCATOR_DEFAULT_CHUNK_CAPACITY, base));
+    bufferCapacity = allocator->Capacity();
+}
+
+void ParseArena::Pool::reset(CountingAllocator *base)
+{
+    // Chunks beyond the buffer mean the last file didn't fit: make room for it
+    size_t capacity = allocator->Capacity();
+    if (capacity > bufferCapacity)
+    {
+        size_t size = buffer.size();
+        while (size < buffer.size() + (capacity - bufferCapacity))
+            size *= 2;
+        init(size, base);
+        return;
+    }
+    allocator->Clear();
+}
+
+// Forget the previous file
+void ParseArena::reset()
+{
+    stackPool.reset(&base);
+}
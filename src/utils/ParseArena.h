@@ -0,0 +1,56 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#ifndef PARSE_ARENA_H
+#define PARSE_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <rapidjson/allocators.h>
+#include "AllocationStats.h"
+
+using namespace std;
+
+using ArenaAllocator = rapidjson::MemoryPoolAllocator<CountingAllocator>;
+
+// Long-lived memory for parsing definitions one after another. Definitions
+// are decoded straight from SAX events, so the only parser memory is its
+// stack, kept in a pool so it always grows in place. reset() rewinds it;
+// a pool that overflowed its buffer is regrown to the high-water mark, so
+// after the largest file has been seen, parsing allocates nothing. One
+// arena per worker; not thread-safe.
+class ParseArena
+{
+public:
+    ParseArena();
+
+    ParseArena(const ParseArena &) = delete;
+    ParseArena &operator=(const ParseArena &) = delete;
+
+    ArenaAllocator &stack() { return *stackPool.allocator; }
+
+    // Forget the previous file
+    void reset();
+
+private:
+    struct Pool
+    {
+        vector<char> buffer;
+        size_t bufferCapacity = 0;
+        unique_ptr<ArenaAllocator> allocator;
+
+        void init(size_t size, CountingAllocator *base);
+        void reset(CountingAllocator *base);
+    };
+
+    CountingAllocator base;
+    Pool stackPool;
+};
+
+#endif
@@ -0,0 +1,347 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <unistd.h>
+#include <unordered_map>
+#include <unordered_set>
+#include "Preflight.h"
+#include "TableMigrationTool.h"
+#include "TableDefinition.h"
+#include "TenantTemplate.h"
+#include "ParseArena.h"
+#include "MappedFile.h"
+#include "WorkerPool.h"
+#include "SigV4.h"
+#include "spdlog/spdlog.h"
+
+namespace
+{
+    // What one definition's check found
+    struct Check
+    {
+        string tableName;
+        string error;
+        shared_ptr<const TableDefinition> parsed; // Kept for the run, without the request body
+        size_t textHash = 0;
+        vector<string> tenantErrors; // Rule violations of each tenant's copy
+        bool unselected = false;
+    };
+
+    // Whether the run handles the definition, or any tenant's copy of a template
+    bool anySelected(const DefinitionSelector &selected, const string &tableName, const string &label, const vector<string> &tenants)
+    {
+        if (tableName.find(tenantPlaceholder) == string::npos || tenants.empty())
+            return selected(tableName, label);
+        for (const auto &tenant : tenants)
+        {
+            if (selected(expandTenantName(tableName, tenant), label + "@" + tenant))
+                return true;
+        }
+        return false;
+    }
+
+    // Check the rules on a decoded definition, or on every tenant's copy of
+    // a template, and keep it if it can be applied. The definition is moved
+    // out of the worker's scratch; its body is read again for CreateTable.
+    void checkDecoded(TableDefinition &definition, const string &label, const vector<string> &tenants, Check &check)
+    {
+        definition.source = label;
+        definition.requestJson = string();
+        if (!isTenantTemplate(definition))
+        {
+            if (!checkTableDefinition(definition, check.error))
+                return;
+            check.tableName = definition.tableName;
+            check.parsed = make_shared<const TableDefinition>(std::move(definition));
+            return;
+        }
+        if (tenants.empty())
+        {
+            check.error = string("TableName contains ") + tenantPlaceholder + " but no tenants were given with --tenants";
+            return;
+        }
+
+        TableDefinition copy;
+        for (const auto &tenant : tenants)
+        {
+            string error;
+            expandTenantTemplate(definition, tenant, copy);
+            checkTableDefinition(copy, error);
+            check.tenantErrors.push_back(std::move(error));
+        }
+        check.parsed = make_shared<const TableDefinition>(std::move(definition));
+    }
+}
+
+// Split the files into definitions and check each one on a pool of workers
+PreflightResult preflightDefinitions(const string &jsonDir, const function<bool(string &filename)> &nextFile,
+                                     const vector<string> &tenants, const DefinitionSelector &selected, bool trackVersions,
+                                     size_t threadCount)
+{
+    PreflightResult result;
+
+    // A deque keeps the addresses the workers write to stable while the
+    // scan appends more entries
+    deque<Check> checks;
+    size_t fileCount = 0;
+
+    // Scratch state owned by one worker thread
+    struct WorkerScratch
+    {
+        ParseArena arena;
+        DefinitionText text;
+        TableDefinition definition; // Moved out into the result once it passes
+    };
+
+    {
+        WorkerPool pool(threadCount);
+        vector<unique_ptr<WorkerScratch>> scratches;
+        for (size_t i = 0; i < pool.size(); ++i)
+            scratches.push_back(make_unique<WorkerScratch>());
+
+        string filename;
+        while (nextFile(filename))
+        {
+            ++fileCount;
+            result.files.push_back(filename);
+
+            // The fingerprint is taken before the read: an edit racing the
+            // read then never matches it, and is applied on the next run
+            shared_ptr<FileVersion> version;
+            if (trackVersions)
+            {
+                version = make_shared<FileVersion>();
+                if (!fingerprintFile(jsonDir + "/" + filename, version->fingerprint))
+                    version.reset();
+            }
+
+            // Read once; the workers take their text from the same buffer
+            auto file = make_shared<MappedFile>();
+            string error;
+            size_t entries = 0;
+            bool wholeFile = true;
+            bool split = file->open(jsonDir + "/" + filename, error) &&
+                         splitDefinitionFile(filename, file->data(), file->size(), wholeFile, [&](size_t offset, size_t length)
+                                             {
+                                                 DefinitionSource source;
+                                                 source.filename = filename;
+                                                 source.label = wholeFile ? filename : filename + "#" + to_string(++entries);
+                                                 source.wholeFile = wholeFile;
+                                                 source.offset = offset;
+                                                 source.length = length;
+                                                 source.version = version;
+
+                                                 Check *check = &checks.emplace_back();
+                                                 result.sources.push_back(source);
+                                                 pool.submit([&, source, check, file](size_t workerId)
+                                                             {
+                                                                 WorkerScratch &scratch = *scratches[workerId];
+                                                                 scratch.text.open(file, source);
+
+                                                                 // Hashed before the in-situ parse overwrites the text
+                                                                 check->textHash = hash<string_view>{}(string_view(scratch.text.data(), scratch.text.size()));
+                                                                 if (source.version && source.wholeFile)
+                                                                     source.version->hash = toHex(sha256(scratch.text.data(), scratch.text.size()));
+
+                                                                 // Another run's definition is dropped on its name alone
+                                                                 if (selected)
+                                                                 {
+                                                                     string tableName = extractTableName(scratch.text.data(), scratch.text.size());
+                                                                     check->unselected = !anySelected(selected, tableName, source.label, tenants);
+                                                                 }
+
+                                                                 if (!check->unselected &&
+                                                                     decodeTableDefinition(scratch.text.data(), scratch.text.size(), scratch.definition, check->error, scratch.arena))
+                                                                     checkDecoded(scratch.definition, source.label, tenants, *check);
+                                                                 scratch.text.close(); }); },
+                                             error);
+
+            // Bundle entries are copies, so the file is hashed as a task of its own
+            if (split && version && !wholeFile)
+                pool.submit([file, version](size_t)
+                            { version->hash = toHex(sha256(file->data(), file->size())); });
+
+            // A file that can't be split is reported as one invalid definition
+            if (!split)
+            {
+                DefinitionSource source;
+                source.filename = filename;
+                source.label = filename;
+                result.sources.push_back(source);
+                checks.push_back({"", error, nullptr, 0, {}, selected && !selected("", filename)});
+            }
+        }
+        pool.wait();
+    }
+
+    // Files may arrive in any order; report in file name order. The
+    // sources of one file were added together and keep their order.
+    vector<size_t> order(result.sources.size());
+    for (size_t index = 0; index < order.size(); ++index)
+        order[index] = index;
+    stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
+                { return result.sources[a].filename < result.sources[b].filename; });
+
+    // Give each tenant of a template a source of its own
+    vector<DefinitionSource> expandedSources;
+    vector<Check> expandedChecks;
+    for (size_t index : order)
+    {
+        Check &check = checks[index];
+        if (check.unselected)
+        {
+            ++result.unselected;
+            continue;
+        }
+        result.sources[index].textHash = check.textHash;
+        if (!check.parsed || !isTenantTemplate(*check.parsed))
+        {
+            result.sources[index].parsed = check.parsed;
+            expandedSources.push_back(std::move(result.sources[index]));
+            expandedChecks.push_back(std::move(check));
+            continue;
+        }
+
+        for (size_t i = 0; i < tenants.size(); ++i)
+        {
+            string tableName = expandTenantName(check.parsed->tableName, tenants[i]);
+            string label = result.sources[index].label + "@" + tenants[i];
+            if (selected && !selected(tableName, label))
+            {
+                ++result.unselected;
+                continue;
+            }
+
+            DefinitionSource source = result.sources[index];
+            source.label = label;
+            source.tenant = tenants[i];
+            source.parsed = check.parsed;
+            expandedSources.push_back(std::move(source));
+            expandedChecks.push_back({tableName, check.tenantErrors[i], nullptr, 0, {}, false});
+        }
+    }
+    result.sources = std::move(expandedSources);
+
+    for (size_t index = 0; index < result.sources.size(); ++index)
+    {
+        const Check &check = expandedChecks[index];
+        if (!check.error.empty())
+            result.issues.push_back({result.sources[index].label, "", check.error});
+    }
+
+    DEBUG_LOG("Pre-flight checked " << result.sources.size() << " definition(s) in " << fileCount << " file(s), "
+                                    << result.issues.size() << " problem(s), " << result.unselected << " left to other runs.");
+    return result;
+}
+
+// Report each definition whose table another definition of the run creates
+void checkDuplicateTables(const string &jsonDir, PreflightResult &result, TableOwners &owners)
+{
+    // The files just read define their tables anew
+    unordered_set<string> files(result.files.begin(), result.files.end());
+    for (auto owner = owners.begin(); owner != owners.end();)
+        owner = files.count(owner->second.filename) ? owners.erase(owner) : next(owner);
+
+    // Keep the issues in source order, with the new ones in place
+    unordered_map<string, vector<PreflightIssue>> issuesByLabel;
+    for (auto &issue : result.issues)
+        issuesByLabel[issue.label].push_back(std::move(issue));
+    result.issues.clear();
+
+    for (const auto &source : result.sources)
+    {
+        auto found = issuesByLabel.find(source.label);
+        if (found != issuesByLabel.end())
+        {
+            for (auto &issue : found->second)
+                result.issues.push_back(std::move(issue));
+            issuesByLabel.erase(found);
+            continue;
+        }
+        if (!source.parsed)
+            continue;
+
+        // Two definitions creating the same table would race each other;
+        // one whose file has since been deleted no longer counts
+        string tableName = source.tenant.empty() ? source.parsed->tableName : expandTenantName(source.parsed->tableName, source.tenant);
+        auto inserted = owners.emplace(tableName, TableOwner{source.filename, source.label});
+        if (inserted.second)
+            continue;
+        if (access((jsonDir + "/" + inserted.first->second.filename).c_str(), F_OK) != 0)
+        {
+            inserted.first->second = {source.filename, source.label};
+            continue;
+        }
+        result.issues.push_back({source.label, tableName, "table " + tableName + " is also defined in " + inserted.first->second.label});
+    }
+
+    for (auto &remaining : issuesByLabel)
+        for (auto &issue : remaining.second)
+            result.issues.push_back(std::move(issue));
+}
+
+// Print every problem as one block
+void printPreflightIssues(const vector<PreflightIssue> &issues)
+{
+    lock_guard<mutex> lock(outputMutex);
+    auto fileLogger = spdlog::get("file_logger");
+
+    cerr << "Pre-flight found " << issues.size() << " invalid definition(s):" << endl;
+    fileLogger->error("Pre-flight found {} invalid definition(s).", issues.size());
+    for (const auto &issue : issues)
+    {
+        cerr << "  - " << issue.label << ": " << issue.message << "." << endl;
+        fileLogger->error("{}: {}.", issue.label, issue.message);
+    }
+}
+
+// Report the problems, if any; returns false when the run must stop
+bool acceptPreflight(PreflightResult &result, bool keepGoing)
+{
+    if (result.issues.empty())
+        return true;
+
+    printPreflightIssues(result.issues);
+    if (!keepGoing)
+    {
+        cerr << "Error: No tables were changed. Fix the definitions above or use --keep-going." << endl;
+        spdlog::get("file_logger")->error("No tables were changed.");
+        return false;
+    }
+
+    unordered_map<string, string> reasons;
+    for (const auto &issue : result.issues)
+        reasons[issue.label] = issue.message;
+    for (auto &source : result.sources)
+    {
+        auto reason = reasons.find(source.label);
+        if (reason != reasons.end())
+            source.invalidReason = reason->second;
+    }
+    return true;
+}
+
+// Check a list of files
+PreflightResult preflightDefinitions(const string &jsonDir, const vector<string> &filenames, const vector<string> &tenants,
+                                     const DefinitionSelector &selected, bool trackVersions, size_t threadCount)
+{
+    size_t next = 0;
+    return preflightDefinitions(
+        jsonDir, [&](string &filename)
+        {
+            if (next == filenames.size())
+                return false;
+            filename = filenames[next++];
+            return true; },
+        tenants, selected, trackVersions, threadCount);
+}
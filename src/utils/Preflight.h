@@ -0,0 +1,86 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#ifndef PREFLIGHT_H
+#define PREFLIGHT_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "DefinitionSource.h"
+
+using namespace std;
+
+// A definition that would fail before reaching DynamoDB
+struct PreflightIssue
+{
+    string label; // File name, or file#N for a bundle entry, plus @tenant for a template
+    string tableName; // Empty when the name itself couldn't be read
+    string message;
+};
+
+struct PreflightResult
+{
+    vector<DefinitionSource> sources; // Every selected definition, in file name order
+    vector<string> files;             // Every file read, in the order read
+    vector<PreflightIssue> issues;    // The problems, in the same order
+    size_t unselected = 0;            // Definitions left to other runs
+};
+
+// Whether this run handles a definition; tableName is empty when it can't
+// be read. Decided on the name alone, before the definition is parsed.
+using DefinitionSelector = function<bool(const string &tableName, const string &label)>;
+
+// Split the files into definitions and parse and validate each one on a
+// pool of threadCount workers, without any remote call. Files are pulled
+// from nextFile until it returns false, so a directory scan can feed them
+// as it finds them. Bundle entries are handed to the workers as the bundle
+// is scanned. A template is parsed once and yields one source per tenant,
+// in tenant order. Each valid source keeps its decoded definition, which
+// is what gets applied. With trackVersions, each source also gets the
+// version of its file that was read, for the definition cache. Definitions
+// that selected (if set) turns down are neither parsed nor returned.
+// Sources are returned in file name order. Duplicate table names are left
+// to checkDuplicateTables().
+PreflightResult preflightDefinitions(const string &jsonDir, const function<bool(string &filename)> &nextFile,
+                                     const vector<string> &tenants, const DefinitionSelector &selected, bool trackVersions,
+                                     size_t threadCount);
+
+// The same for a list of files
+PreflightResult preflightDefinitions(const string &jsonDir, const vector<string> &filenames, const vector<string> &tenants,
+                                     const DefinitionSelector &selected, bool trackVersions, size_t threadCount);
+
+// The definition that creates a table
+struct TableOwner
+{
+    string filename;
+    string label;
+};
+
+// Table name -> its definition, across every pre-flight of a run
+using TableOwners = unordered_map<string, TableOwner>;
+
+// Report each definition whose table is already created by another
+// definition of the run: an earlier one of the same result, or one in
+// owners, which carries over from earlier checks (files unchanged since
+// the last run, earlier --watch cycles). Tables of the files in result are
+// released first, since those files define their tables anew. Call it
+// before acceptPreflight().
+void checkDuplicateTables(const string &jsonDir, PreflightResult &result, TableOwners &owners);
+
+// Print every problem as one block
+void printPreflightIssues(const vector<PreflightIssue> &issues);
+
+// Report the problems, if any. Returns false when the run must stop;
+// with keepGoing the invalid definitions are marked and stay in the run,
+// so they show up in order in the summary.
+bool acceptPreflight(PreflightResult &result, bool keepGoing);
+
+#endif
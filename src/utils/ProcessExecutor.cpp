@@ -0,0 +1,268 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <mutex>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "ProcessExecutor.h"
+#include "TableMigrationTool.h"
+
+extern char **environ;
+
+namespace
+{
+    // Poll interval while waiting for a child that has closed its pipes to exit
+    const auto reapInterval = chrono::milliseconds(2);
+
+    // A child that exits without reading all of its input must not kill us
+    // with SIGPIPE; the write fails with EPIPE instead
+    void ignoreSigpipe()
+    {
+        static once_flag ignored;
+        call_once(ignored, []
+                  { signal(SIGPIPE, SIG_IGN); });
+    }
+
+    // A pipe whose ends aren't inherited by other children. pipe2() sets
+    // the flag atomically but is Linux-only; elsewhere it is set after.
+    bool openPipe(int fds[2])
+    {
+#ifdef __linux__
+        return pipe2(fds, O_CLOEXEC) == 0;
+#else
+        if (pipe(fds) != 0)
+            return false;
+        fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+        fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+        return true;
+#endif
+    }
+
+    // A spawned child and the parent ends of its stdin/stdout/stderr pipes
+    class ChildProcess : public enable_shared_from_this<ChildProcess>
+    {
+    public:
+        ChildProcess(EventLoop &loop, const vector<string> &argv, function<void(CommandResult)> done, string input)
+            : loop(loop), argv(argv), done(std::move(done)), input(std::move(input))
+        {
+        }
+
+        void start()
+        {
+            int outPipe[2], errPipe[2], inPipe[2] = {-1, -1};
+            if (!openPipe(outPipe))
+            {
+                fail(string("pipe: ") + strerror(errno));
+                return;
+            }
+            if (!openPipe(errPipe))
+            {
+                close(outPipe[0]);
+                close(outPipe[1]);
+                fail(string("pipe: ") + strerror(errno));
+                return;
+            }
+            if (!input.empty() && !openPipe(inPipe))
+            {
+                close(outPipe[0]);
+                close(outPipe[1]);
+                close(errPipe[0]);
+                close(errPipe[1]);
+                fail(string("pipe: ") + strerror(errno));
+                return;
+            }
+
+            posix_spawn_file_actions_t actions;
+            posix_spawn_file_actions_init(&actions);
+            if (inPipe[0] >= 0)
+                posix_spawn_file_actions_adddup2(&actions, inPipe[0], STDIN_FILENO);
+            else
+                posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+            posix_spawn_file_actions_adddup2(&actions, outPipe[1], STDOUT_FILENO);
+            posix_spawn_file_actions_adddup2(&actions, errPipe[1], STDERR_FILENO);
+
+            vector<char *> args;
+            args.reserve(argv.size() + 1);
+            for (const auto &arg : argv)
+                args.push_back(const_cast<char *>(arg.c_str()));
+            args.push_back(nullptr);
+
+            int spawnError = posix_spawnp(&pid, args[0], &actions, nullptr, args.data(), environ);
+            posix_spawn_file_actions_destroy(&actions);
+            close(outPipe[1]);
+            close(errPipe[1]);
+            if (inPipe[0] >= 0)
+                close(inPipe[0]);
+
+            if (spawnError != 0)
+            {
+                close(outPipe[0]);
+                close(errPipe[0]);
+                if (inPipe[1] >= 0)
+                    close(inPipe[1]);
+                fail("Unable to start " + argv[0] + ": " + strerror(spawnError));
+                return;
+            }
+
+            // Drain both pipes as data arrives so a chatty child never blocks
+            fds[0] = outPipe[0];
+            fds[1] = errPipe[0];
+            auto self = shared_from_this();
+            for (int i = 0; i < 2; ++i)
+            {
+                fcntl(fds[i], F_SETFL, fcntl(fds[i], F_GETFL) | O_NONBLOCK);
+                loop.watch(fds[i], EventLoop::Readable, [self, i](uint32_t)
+                           { self->drain(i); });
+            }
+
+            // Feed stdin as the pipe takes it, alongside the draining
+            if (inPipe[1] >= 0)
+            {
+                inFd = inPipe[1];
+                ignoreSigpipe();
+                fcntl(inFd, F_SETFL, fcntl(inFd, F_GETFL) | O_NONBLOCK);
+                loop.watch(inFd, EventLoop::Writable, [self](uint32_t)
+                           { self->feed(); });
+            }
+        }
+
+    private:
+        void feed()
+        {
+            while (written < input.size())
+            {
+                ssize_t count = write(inFd, input.data() + written, input.size() - written);
+                if (count > 0)
+                {
+                    written += static_cast<size_t>(count);
+                    continue;
+                }
+                if (count < 0 && errno == EINTR)
+                    continue;
+                if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                    return;
+                break; // EPIPE: the child stopped reading
+            }
+            closeInput();
+        }
+
+        // Closing stdin is the child's end of input
+        void closeInput()
+        {
+            if (inFd < 0)
+                return;
+            loop.unwatch(inFd);
+            close(inFd);
+            inFd = -1;
+        }
+
+        void drain(int index)
+        {
+            string &sink = index == 0 ? result.output : result.errorOutput;
+            char buffer[16384];
+            while (true)
+            {
+                ssize_t count = read(fds[index], buffer, sizeof(buffer));
+                if (count > 0)
+                {
+                    sink.append(buffer, static_cast<size_t>(count));
+                    continue;
+                }
+                if (count < 0 && errno == EINTR)
+                    continue;
+                if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                    return;
+
+                // EOF or error: this stream is finished
+                loop.unwatch(fds[index]);
+                close(fds[index]);
+                fds[index] = -1;
+                if (fds[0] < 0 && fds[1] < 0)
+                    reap();
+                return;
+            }
+        }
+
+        // Collect the exit status without blocking the loop
+        void reap()
+        {
+            closeInput();
+            int status = 0;
+            pid_t reaped = waitpid(pid, &status, WNOHANG);
+            if (reaped == 0 || (reaped < 0 && errno == EINTR))
+            {
+                auto self = shared_from_this();
+                loop.runAfter(reapInterval, [self]
+                              { self->reap(); });
+                return;
+            }
+
+            if (reaped == pid && WIFEXITED(status))
+                result.exitCode = WEXITSTATUS(status);
+            else if (reaped == pid && WIFSIGNALED(status))
+                result.exitCode = 128 + WTERMSIG(status);
+
+            string summary = argv[0];
+            for (size_t i = 1; i < argv.size() && i < 3; ++i)
+                summary += " " + argv[i];
+            DEBUG_LOG("Command '" << summary << "' exited with " << result.exitCode);
+
+            done(std::move(result));
+        }
+
+        void fail(const string &error)
+        {
+            result.errorOutput = error;
+            auto self = shared_from_this();
+            loop.post([self]
+                      { self->done(std::move(self->result)); });
+        }
+
+        EventLoop &loop;
+        vector<string> argv;
+        function<void(CommandResult)> done;
+        CommandResult result;
+        pid_t pid = -1;
+        int fds[2] = {-1, -1};
+        string input;
+        size_t written = 0;
+        int inFd = -1;
+    };
+}
+
+// Run a program on the event loop and report its output when it exits
+void runCommandAsync(EventLoop &loop, const vector<string> &argv, function<void(CommandResult)> done, string input)
+{
+    if (argv.empty())
+    {
+        loop.post([done]
+                  { done(CommandResult()); });
+        return;
+    }
+
+    make_shared<ChildProcess>(loop, argv, std::move(done), std::move(input))->start();
+}
+
+// Run a program directly (no shell) and capture its output in memory
+CommandResult runCommand(const vector<string> &argv)
+{
+    EventLoop loop;
+    CommandResult result;
+    runCommandAsync(loop, argv, [&](CommandResult finished)
+                    {
+                        result = std::move(finished);
+                        loop.stop(); });
+    loop.run();
+    return result;
+}
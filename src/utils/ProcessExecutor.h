@@ -0,0 +1,39 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#ifndef PROCESS_EXECUTOR_H
+#define PROCESS_EXECUTOR_H
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "EventLoop.h"
+
+using namespace std;
+
+// Exit status and captured output of a child process
+struct CommandResult
+{
+    int exitCode = -1;
+    string output;      // Everything the child wrote to stdout
+    string errorOutput; // Everything the child wrote to stderr
+
+    bool ok() const { return exitCode == 0; }
+};
+
+// Run a program directly (no shell) and capture its stdout and stderr in
+// memory. argv[0] is looked up on PATH.
+CommandResult runCommand(const vector<string> &argv);
+
+// Same as runCommand(), but the child's pipes are drained by the event loop
+// and done is called on the loop thread once the child has exited. A
+// non-empty input is written to the child's stdin, which is otherwise
+// /dev/null; it can be any size, unlike an argument.
+void runCommandAsync(EventLoop &loop, const vector<string> &argv, function<void(CommandResult)> done, string input = "");
+
+#endif
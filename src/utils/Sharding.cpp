@@ -0,0 +1,130 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include "Sharding.h"
+#include "DefinitionScanner.h"
+#include "DefinitionFilter.h"
+#include "DefinitionSource.h"
+#include "MappedFile.h"
+#include "TenantTemplate.h"
+#include "TableMigrationTool.h"
+#include "spdlog/spdlog.h"
+
+// Parse "i/N" with 1 <= i <= N
+bool parseShardSpec(const string &text, ShardSpec &shard, string &error)
+{
+    size_t slash = text.find('/');
+    char *end = nullptr;
+    unsigned long index = slash == string::npos ? 0 : strtoul(text.c_str(), &end, 10);
+    bool indexOk = slash != string::npos && end == text.c_str() + slash;
+    unsigned long count = indexOk ? strtoul(text.c_str() + slash + 1, &end, 10) : 0;
+    if (!indexOk || *end != '\0' || count == 0 || index == 0 || index > count)
+    {
+        error = "--shard expects i/N with 1 <= i <= N, e.g. 2/4";
+        return false;
+    }
+
+    shard.index = index;
+    shard.count = count;
+    return true;
+}
+
+// The 1-based shard a key belongs to
+size_t shardOf(const string &key, size_t count)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : key)
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    return static_cast<size_t>(hash % count) + 1;
+}
+
+// Whether this shard handles a definition
+bool ownsDefinition(const ShardSpec &shard, const string &tableName, const string &label)
+{
+    if (!shard.enabled())
+        return true;
+    return shardOf(tableName.empty() ? label : tableName, shard.count) == shard.index;
+}
+
+// Print how the definitions spread over count shards
+void listShards(const string &jsonDir, DefinitionScanner &scanner, const vector<string> &tenants, const DefinitionFilter &filter,
+                size_t count)
+{
+    vector<size_t> tables(count + 1, 0);
+    vector<vector<string>> names(count + 1);
+
+    // Only the names are read, with the early-stopping extractor
+    auto assign = [&](const string &tableName, const string &label)
+    {
+        if (!filter.acceptsTableName(tableName))
+            return;
+        size_t shard = shardOf(tableName.empty() ? label : tableName, count);
+        ++tables[shard];
+        if (debug)
+            names[shard].push_back(tableName.empty() ? label + " (no TableName)" : tableName);
+    };
+
+    string filename;
+    size_t files = 0;
+    while (scanner.next(filename))
+    {
+        if (!filter.acceptsPath(filename))
+            continue;
+        ++files;
+        MappedFile file;
+        string error;
+        size_t entries = 0;
+        bool wholeFile = true;
+        bool split = file.open(jsonDir + "/" + filename, error) &&
+                     splitDefinitionFile(filename, file.data(), file.size(), wholeFile, [&](size_t offset, size_t length)
+                                         {
+                                             string label = wholeFile ? filename : filename + "#" + to_string(++entries);
+                                             string tableName = extractTableName(file.data() + offset, length);
+                                             if (tableName.find(tenantPlaceholder) == string::npos || tenants.empty())
+                                             {
+                                                 assign(tableName, label);
+                                                 return;
+                                             }
+                                             for (const auto &tenant : tenants)
+                                                 assign(expandTenantName(tableName, tenant), label + "@" + tenant); },
+                                         error);
+        if (!split)
+            assign("", filename);
+    }
+
+    size_t total = 0;
+    size_t largest = 0;
+    for (size_t shard = 1; shard <= count; ++shard)
+    {
+        total += tables[shard];
+        largest = max(largest, tables[shard]);
+    }
+
+    cout << total << " definition(s) in " << files << " file(s) over " << count << " shard(s):" << endl;
+    spdlog::get("file_logger")->info("{} definition(s) in {} file(s) over {} shard(s).", total, files, count);
+    for (size_t shard = 1; shard <= count; ++shard)
+    {
+        cout << "  Shard " << shard << "/" << count << ": " << tables[shard] << " definition(s)" << endl;
+        spdlog::get("file_logger")->info("Shard {}/{}: {} definition(s).", shard, count, tables[shard]);
+
+        sort(names[shard].begin(), names[shard].end());
+        for (const auto &name : names[shard])
+            DEBUG_LOG("    " << name);
+    }
+
+    // How much longer the busiest runner takes than an even split would
+    if (total > 0)
+    {
+        double ratio = static_cast<double>(largest) * count / total;
+        cout << "Largest shard is " << static_cast<int>(ratio * 100 + 0.5) << "% of an even split." << endl;
+        spdlog::get("file_logger")->info("Largest shard is {:.0f}% of an even split.", ratio * 100);
+    }
+}
@@ -0,0 +1,49 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#ifndef SHARDING_H
+#define SHARDING_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class DefinitionScanner;
+class DefinitionFilter;
+
+// One runner's part of a migration split across count runners; index is
+// 1-based, as in --shard 2/4. A count of zero means no sharding.
+struct ShardSpec
+{
+    size_t index = 0;
+    size_t count = 0;
+
+    bool enabled() const { return count > 0; }
+};
+
+// Parse "i/N" with 1 <= i <= N
+bool parseShardSpec(const string &text, ShardSpec &shard, string &error);
+
+// The 1-based shard a key belongs to: a 64-bit FNV-1a hash of the key,
+// modulo count, so every runner and platform agrees
+size_t shardOf(const string &key, size_t count);
+
+// Whether this shard handles a definition. Definitions are assigned by
+// TableName; one whose name can't be read is assigned by its label, so
+// exactly one shard reports it.
+bool ownsDefinition(const ShardSpec &shard, const string &tableName, const string &label);
+
+// Print how the definitions the scanner finds spread over count shards,
+// reading only each definition's TableName. Template names are expanded
+// for every tenant. Definitions the filter turns down aren't counted.
+void listShards(const string &jsonDir, DefinitionScanner &scanner, const vector<string> &tenants, const DefinitionFilter &filter,
+                size_t count);
+
+#endif
@@ -0,0 +1,281 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include "SigV4.h"
+
+namespace
+{
+    const uint32_t sha256RoundConstants[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+    inline uint32_t rotateRight(uint32_t value, int bits)
+    {
+        return (value >> bits) | (value << (32 - bits));
+    }
+
+    void sha256Block(uint32_t state[8], const unsigned char *block)
+    {
+        uint32_t w[64];
+        for (int i = 0; i < 16; ++i)
+        {
+            w[i] = (uint32_t(block[i * 4]) << 24) | (uint32_t(block[i * 4 + 1]) << 16) |
+                   (uint32_t(block[i * 4 + 2]) << 8) | uint32_t(block[i * 4 + 3]);
+        }
+        for (int i = 16; i < 64; ++i)
+        {
+            uint32_t s0 = rotateRight(w[i - 15], 7) ^ rotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = rotateRight(w[i - 2], 17) ^ rotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int i = 0; i < 64; ++i)
+        {
+            uint32_t s1 = rotateRight(e, 6) ^ rotateRight(e, 11) ^ rotateRight(e, 25);
+            uint32_t choose = (e & f) ^ (~e & g);
+            uint32_t temp1 = h + s1 + choose + sha256RoundConstants[i] + w[i];
+            uint32_t s0 = rotateRight(a, 2) ^ rotateRight(a, 13) ^ rotateRight(a, 22);
+            uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+            uint32_t temp2 = s0 + majority;
+
+            h = g;
+            g = f;
+            f = e;
+            e = d + temp1;
+            d = c;
+            c = b;
+            b = a;
+            a = temp1 + temp2;
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+
+    // Read "key = value" from the named [section] of an INI-style AWS file
+    string readIniValue(const string &path, const string &section, const string &key)
+    {
+        ifstream file(path);
+        if (!file.is_open())
+            return "";
+
+        auto trim = [](string value)
+        {
+            size_t start = value.find_first_not_of(" \t\r");
+            size_t end = value.find_last_not_of(" \t\r");
+            return start == string::npos ? string() : value.substr(start, end - start + 1);
+        };
+
+        string line;
+        bool inSection = false;
+        while (getline(file, line))
+        {
+            line = trim(line);
+            if (line.empty() || line[0] == '#' || line[0] == ';')
+                continue;
+
+            if (line.front() == '[' && line.back() == ']')
+            {
+                inSection = trim(line.substr(1, line.size() - 2)) == section;
+                continue;
+            }
+
+            size_t equals = line.find('=');
+            if (inSection && equals != string::npos && trim(line.substr(0, equals)) == key)
+                return trim(line.substr(equals + 1));
+        }
+
+        return "";
+    }
+
+    string envOrEmpty(const char *name)
+    {
+        const char *value = getenv(name);
+        return value ? value : "";
+    }
+
+    string awsFilePath(const char *envName, const string &defaultName)
+    {
+        string path = envOrEmpty(envName);
+        if (!path.empty())
+            return path;
+
+        string home = envOrEmpty("HOME");
+        if (home.empty())
+            home = envOrEmpty("USERPROFILE");
+        return home + "/.aws/" + defaultName;
+    }
+}
+
+// SHA-256 digest of data as raw bytes
+string sha256(const string &data)
+{
+    return sha256(data.data(), data.size());
+}
+
+string sha256(const char *data, size_t length)
+{
+    uint32_t state[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+    size_t offset = 0;
+    for (; offset + 64 <= length; offset += 64)
+        sha256Block(state, bytes + offset);
+
+    // Final block(s): remaining bytes, 0x80, zero padding, 64-bit bit length
+    unsigned char tail[128] = {0};
+    size_t remaining = length - offset;
+    for (size_t i = 0; i < remaining; ++i)
+        tail[i] = bytes[offset + i];
+    tail[remaining] = 0x80;
+
+    size_t tailLength = remaining + 1 + 8 <= 64 ? 64 : 128;
+    uint64_t bitLength = static_cast<uint64_t>(length) * 8;
+    for (int i = 0; i < 8; ++i)
+        tail[tailLength - 1 - i] = static_cast<unsigned char>(bitLength >> (i * 8));
+
+    sha256Block(state, tail);
+    if (tailLength == 128)
+        sha256Block(state, tail + 64);
+
+    string digest(32, '\0');
+    for (int i = 0; i < 8; ++i)
+    {
+        digest[i * 4] = static_cast<char>(state[i] >> 24);
+        digest[i * 4 + 1] = static_cast<char>(state[i] >> 16);
+        digest[i * 4 + 2] = static_cast<char>(state[i] >> 8);
+        digest[i * 4 + 3] = static_cast<char>(state[i]);
+    }
+    return digest;
+}
+
+// Lowercase hex encoding of raw bytes
+string toHex(const string &bytes)
+{
+    static const char digits[] = "0123456789abcdef";
+    string hex;
+    hex.reserve(bytes.size() * 2);
+    for (unsigned char byte : bytes)
+    {
+        hex += digits[byte >> 4];
+        hex += digits[byte & 0x0f];
+    }
+    return hex;
+}
+
+// HMAC-SHA256 of data under key, as raw bytes
+string hmacSha256(const string &key, const string &data)
+{
+    string blockKey = key.size() > 64 ? sha256(key) : key;
+    blockKey.resize(64, '\0');
+
+    string innerPad(64, '\0'), outerPad(64, '\0');
+    for (size_t i = 0; i < 64; ++i)
+    {
+        innerPad[i] = static_cast<char>(blockKey[i] ^ 0x36);
+        outerPad[i] = static_cast<char>(blockKey[i] ^ 0x5c);
+    }
+
+    return sha256(outerPad + sha256(innerPad + data));
+}
+
+// Resolve credentials from the environment or the shared credentials file
+AwsCredentials loadAwsCredentials()
+{
+    AwsCredentials credentials;
+    credentials.accessKeyId = envOrEmpty("AWS_ACCESS_KEY_ID");
+    credentials.secretAccessKey = envOrEmpty("AWS_SECRET_ACCESS_KEY");
+    credentials.sessionToken = envOrEmpty("AWS_SESSION_TOKEN");
+
+    if (credentials.accessKeyId.empty() || credentials.secretAccessKey.empty())
+    {
+        string profile = envOrEmpty("AWS_PROFILE");
+        if (profile.empty())
+            profile = "default";
+
+        string path = awsFilePath("AWS_SHARED_CREDENTIALS_FILE", "credentials");
+        credentials.accessKeyId = readIniValue(path, profile, "aws_access_key_id");
+        credentials.secretAccessKey = readIniValue(path, profile, "aws_secret_access_key");
+        credentials.sessionToken = readIniValue(path, profile, "aws_session_token");
+    }
+
+    return credentials;
+}
+
+// Resolve the region from the environment or the shared config file
+string loadAwsRegion()
+{
+    string region = envOrEmpty("AWS_REGION");
+    if (region.empty())
+        region = envOrEmpty("AWS_DEFAULT_REGION");
+
+    if (region.empty())
+    {
+        string profile = envOrEmpty("AWS_PROFILE");
+        string section = profile.empty() || profile == "default" ? "default" : "profile " + profile;
+        region = readIniValue(awsFilePath("AWS_CONFIG_FILE", "config"), section, "region");
+    }
+
+    return region.empty() ? "us-east-1" : region;
+}
+
+// Sign a request with AWS Signature Version 4
+void signRequestV4(map<string, string> &headers, const string &method, const string &path, const string &body,
+                   const string &region, const string &service, const AwsCredentials &credentials, time_t now)
+{
+    char amzDate[17], dateStamp[9];
+    tm utc;
+    gmtime_r(&now, &utc);
+    strftime(amzDate, sizeof(amzDate), "%Y%m%dT%H%M%SZ", &utc);
+    strftime(dateStamp, sizeof(dateStamp), "%Y%m%d", &utc);
+
+    headers["x-amz-date"] = amzDate;
+    if (!credentials.sessionToken.empty())
+        headers["x-amz-security-token"] = credentials.sessionToken;
+
+    // Canonical request; the map keeps header names sorted as required
+    string canonicalHeaders, signedHeaders;
+    for (const auto &header : headers)
+    {
+        canonicalHeaders += header.first + ":" + header.second + "\n";
+        if (!signedHeaders.empty())
+            signedHeaders += ';';
+        signedHeaders += header.first;
+    }
+
+    string canonicalRequest = method + "\n" + path + "\n\n" + canonicalHeaders + "\n" + signedHeaders + "\n" + toHex(sha256(body));
+
+    string scope = string(dateStamp) + "/" + region + "/" + service + "/aws4_request";
+    string stringToSign = "AWS4-HMAC-SHA256\n" + string(amzDate) + "\n" + scope + "\n" + toHex(sha256(canonicalRequest));
+
+    string signingKey = hmacSha256("AWS4" + credentials.secretAccessKey, dateStamp);
+    signingKey = hmacSha256(signingKey, region);
+    signingKey = hmacSha256(signingKey, service);
+    signingKey = hmacSha256(signingKey, "aws4_request");
+
+    headers["authorization"] = "AWS4-HMAC-SHA256 Credential=" + credentials.accessKeyId + "/" + scope +
+                               ", SignedHeaders=" + signedHeaders +
+                               ", Signature=" + toHex(hmacSha256(signingKey, stringToSign));
+}
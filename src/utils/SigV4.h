@@ -0,0 +1,47 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#ifndef SIGV4_H
+#define SIGV4_H
+
+#include <ctime>
+#include <map>
+#include <string>
+
+using namespace std;
+
+struct AwsCredentials
+{
+    string accessKeyId;
+    string secretAccessKey;
+    string sessionToken;
+};
+
+// SHA-256 digest of data as raw bytes
+string sha256(const string &data);
+string sha256(const char *data, size_t length);
+
+// Lowercase hex encoding of raw bytes
+string toHex(const string &bytes);
+
+// HMAC-SHA256 of data under key, as raw bytes
+string hmacSha256(const string &key, const string &data);
+
+// Resolve credentials and region the way the AWS CLI does for the common
+// cases: environment variables first, then the shared credentials/config
+// files for AWS_PROFILE (or "default").
+AwsCredentials loadAwsCredentials();
+string loadAwsRegion();
+
+// Sign a request with AWS Signature Version 4. headers must already contain
+// "host" and is keyed by lowercase header name; x-amz-date, the session token
+// and authorization headers are added.
+void signRequestV4(map<string, string> &headers, const string &method, const string &path, const string &body,
+                   const string &region, const string &service, const AwsCredentials &credentials, time_t now);
+
+#endif
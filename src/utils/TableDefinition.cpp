@@ -0,0 +1,76 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#include <rapidjson/error/en.h>
+#include <rapidjson/reader.h>
+#include "TableDefinition.h"
+#include "ParseArena.h"
+#include "DefinitionDecoder.h"
+#include "DefinitionSchema.h"
+#include "DefinitionRules.h"
+
+using namespace rapidjson;
+
+// Decode a NUL-terminated definition in place in a single SAX pass: the
+// schema validator checks each event and hands it on to the typed decoder
+bool decodeTableDefinition(char *json, size_t length, TableDefinition &definition, string &error, ParseArena &arena)
+{
+    arena.reset();
+
+    // The text is sent as the CreateTable body; in-situ parsing overwrites it
+    definition.requestJson.assign(json, length);
+
+    // Reset keeps the validator's stacks, so only failures allocate
+    thread_local DefinitionDecoder decoder;
+    thread_local DefinitionValidator validator(createTableSchema(), decoder);
+    decoder.reset(definition);
+    validator.Reset();
+
+    GenericReader<UTF8<>, UTF8<>, ArenaAllocator> reader(&arena.stack());
+    InsituStringStream stream(json);
+    ParseResult result = reader.Parse<kParseInsituFlag>(stream, validator);
+    if (!validator.IsValid())
+    {
+        error = describeSchemaError(validator);
+        return false;
+    }
+    if (result.IsError())
+    {
+        // rapidjson's messages end with a period; callers add their own
+        error = string("JSON parse error at offset ") + to_string(result.Offset()) + ": " + GetParseError_En(result.Code());
+        if (!error.empty() && error.back() == '.')
+            error.pop_back();
+        return false;
+    }
+    if (definition.tableName.empty())
+    {
+        error = "TableName is missing";
+        return false;
+    }
+    return true;
+}
+
+// Rule violations that DynamoDB would reject, all reported together
+bool checkTableDefinition(const TableDefinition &definition, string &error)
+{
+    vector<string> violations = checkDefinitionRules(definition);
+    if (!violations.empty())
+    {
+        error.clear();
+        for (const auto &violation : violations)
+            error += (error.empty() ? "" : "; ") + violation;
+        return false;
+    }
+    return true;
+}
+
+// Decode, then check the rules
+bool parseTableDefinition(char *json, size_t length, TableDefinition &definition, string &error, ParseArena &arena)
+{
+    return decodeTableDefinition(json, length, definition, error, arena) && checkTableDefinition(definition, error);
+}
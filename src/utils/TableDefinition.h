@@ -0,0 +1,81 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#ifndef TABLE_DEFINITION_H
+#define TABLE_DEFINITION_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct KeySchemaElement
+{
+    string attributeName;
+    string keyType; // HASH or RANGE
+};
+
+struct AttributeDefinition
+{
+    string attributeName;
+    string attributeType; // S, N or B
+};
+
+struct ProvisionedThroughput
+{
+    long long readCapacityUnits = 0;
+    long long writeCapacityUnits = 0;
+};
+
+// A GlobalSecondaryIndexes or LocalSecondaryIndexes entry
+struct SecondaryIndex
+{
+    string indexName;
+    vector<KeySchemaElement> keySchema;
+    string projectionType;
+    vector<string> nonKeyAttributes;
+    bool hasProvisionedThroughput = false;
+    ProvisionedThroughput provisionedThroughput;
+};
+
+// One definition file, loaded once and shared by the existence check,
+// validation and the CreateTable request. Fields the tool doesn't model
+// (tags, SSE, ...) are kept only in requestJson.
+struct TableDefinition
+{
+    string source; // File name, or file#N for a bundle entry
+    string tableName;
+    vector<KeySchemaElement> keySchema;
+    vector<AttributeDefinition> attributeDefinitions;
+    vector<SecondaryIndex> globalSecondaryIndexes;
+    vector<SecondaryIndex> localSecondaryIndexes;
+    string billingMode; // Empty when the file doesn't set it (PROVISIONED)
+    bool hasProvisionedThroughput = false;
+    ProvisionedThroughput provisionedThroughput;
+    bool streamEnabled = false;
+    string streamViewType;
+
+    // The definition text, sent as the CreateTable request body
+    string requestJson;
+};
+
+class ParseArena;
+
+// Validate and decode a NUL-terminated definition of length bytes in place;
+// the text is overwritten and the parser stack lives in the arena, which
+// is reset first
+bool decodeTableDefinition(char *json, size_t length, TableDefinition &definition, string &error, ParseArena &arena);
+
+// Check a decoded definition against the DynamoDB rules; all violations
+// are reported in error, separated by "; "
+bool checkTableDefinition(const TableDefinition &definition, string &error);
+
+// decodeTableDefinition followed by checkTableDefinition
+bool parseTableDefinition(char *json, size_t length, TableDefinition &definition, string &error, ParseArena &arena);
+
+#endif
@@ -7,59 +7,192 @@
  * MIT Licensed
  */
 
+#include <cstring>
+#include <unordered_set>
 #include "TableMigrationTool.h"
+#include <rapidjson/memorystream.h>
+#include <rapidjson/reader.h>
+#include "MappedFile.h"
+#include "AllocationStats.h"
+#include "DynamoDBClient.h"
 
 bool force = false;
 bool debug = false;
+bool waitForActive = false;
 string appDir;
 string tempDir;
+mutex outputMutex;
+
+// Table names seen by the startup ListTables snapshot, and the tables this run
+// has changed since (whose state can only be known by asking the remote again)
+static unordered_set<string> snapshotTables;
+static unordered_set<string> changedTables;
+static bool snapshotLoaded = false;
+static mutex snapshotMutex;
 
 // Check if a table exists by attempting to describe it
+static bool describeTableExists(const string &tableName)
+{
+    return dynamoClient().describeTable(tableName).ok();
+}
+
+// Check if a table exists, answering from the ListTables snapshot when possible
 bool tableExists(const string &tableName)
 {
     DEBUG_LOG("Checking if table exists: " << tableName);
 
-    // Use the AWS CLI to describe the table and check if it exists
-    string command = "aws dynamodb describe-table --table-name " + tableName + " --output json > NUL 2>&1";
-    int result = system(command.c_str());
-    return result == 0;
+    bool exists = false;
+    if (lookupTableSnapshot(tableName, exists))
+        return exists;
+
+    return describeTableExists(tableName);
 }
 
-// Check if DynamoDB can be accessed
+// Answer from the snapshot if it can; returns false when the remote must be asked
+bool lookupTableSnapshot(const string &tableName, bool &exists)
+{
+    lock_guard<mutex> lock(snapshotMutex);
+    if (!snapshotLoaded || changedTables.count(tableName) != 0)
+        return false;
+
+    exists = snapshotTables.count(tableName) != 0;
+    return true;
+}
+
+// Record that this run created or deleted a table
+void markTableChanged(const string &tableName)
+{
+    lock_guard<mutex> lock(snapshotMutex);
+    changedTables.insert(tableName);
+}
+
+// Fetch every page of ListTables into the snapshot
+static bool loadTableSnapshot()
+{
+    unordered_set<string> tables;
+    string nextToken;
+
+    do
+    {
+        DynamoResult page = dynamoClient().listTables(nextToken);
+        if (!page.ok())
+        {
+            DEBUG_LOG("ListTables failed: " << page.message);
+            return false;
+        }
+
+        tables.insert(page.tableNames.begin(), page.tableNames.end());
+        nextToken = page.nextToken;
+    } while (!nextToken.empty());
+
+    DEBUG_LOG("Loaded " << tables.size() << " table name(s) from ListTables.");
+
+    lock_guard<mutex> lock(snapshotMutex);
+    snapshotTables = std::move(tables);
+    changedTables.clear();
+    snapshotLoaded = true;
+    return true;
+}
+
+// Check if DynamoDB can be accessed, keeping the table list for tableExists()
 bool canAccessDynamoDB()
 {
     DEBUG_LOG("Checking if DynamoDB can be accessed.");
 
-    // Use the AWS CLI to describe the table and check if it exists
-    string command = "aws dynamodb list-tables --output json > NUL 2>&1";
-    int result = system(command.c_str());
-    return result == 0;
+    return loadTableSnapshot();
 }
 
-// Get the table name from a JSON file
-string getTableNameFromJson(const string &jsonFilePath)
+namespace
 {
-    DEBUG_LOG("Getting table name from JSON: " << jsonFilePath);
-
-    ifstream file(jsonFilePath);
-    if (file.is_open())
+    // SAX handler that captures the top-level TableName and then aborts the
+    // parse, so the rest of the file (seed items, index lists) is never read
+    struct TableNameHandler : BaseReaderHandler<UTF8<>, TableNameHandler>
     {
-        // Parse JSON using rapidjson
-        IStreamWrapper inputStream(file);
+        int depth = 0;
+        bool atTableName = false;
+        bool found = false;
+        string tableName;
 
-        Document root;
-        root.ParseStream(inputStream);
+        bool Key(const char *key, SizeType length, bool)
+        {
+            atTableName = depth == 1 && length == 9 && memcmp(key, "TableName", 9) == 0;
+            return true;
+        }
 
-        if (!root.HasParseError() && root.HasMember("TableName") && root["TableName"].IsString())
+        bool String(const char *value, SizeType length, bool)
         {
-            string tableName = root["TableName"].GetString();
-            DEBUG_LOG("Extracted table name: " << tableName);
-            return tableName;
+            if (atTableName)
+            {
+                tableName.assign(value, length);
+                found = true;
+                return false;
+            }
+            return true;
         }
-    }
 
-    DEBUG_LOG("Table name extraction failed.");
-    return "";
+        bool StartObject()
+        {
+            // A non-string TableName ends the search
+            if (atTableName)
+                return false;
+            ++depth;
+            return true;
+        }
+
+        bool EndObject(SizeType)
+        {
+            --depth;
+            return true;
+        }
+
+        bool StartArray()
+        {
+            // So does a root that isn't an object
+            if (atTableName || depth == 0)
+                return false;
+            ++depth;
+            return true;
+        }
+
+        bool EndArray(SizeType)
+        {
+            --depth;
+            return true;
+        }
+
+        // Numbers, booleans and null
+        bool Default() { return !atTableName && depth > 0; }
+    };
+}
+
+// Get the table name from JSON text, reading only as far as TableName
+string extractTableName(const char *json, size_t length)
+{
+    // The reader keeps its stack between calls, so lookups don't allocate
+    thread_local GenericReader<UTF8<>, UTF8<>, CountingAllocator> reader;
+
+    MemoryStream inputStream(json, length);
+    TableNameHandler handler;
+    reader.Parse(inputStream, handler);
+    return handler.found ? handler.tableName : "";
+}
+
+// Get the table name from a JSON file; only the pages up to TableName are read
+string getTableNameFromJson(const string &jsonFilePath)
+{
+    DEBUG_LOG("Getting table name from JSON: " << jsonFilePath);
+
+    MappedFile file;
+    string error;
+    string tableName;
+    if (file.open(jsonFilePath, error))
+        tableName = extractTableName(file.data(), file.size());
+
+    if (tableName.empty())
+        DEBUG_LOG("Table name extraction failed.");
+    else
+        DEBUG_LOG("Extracted table name: " << tableName);
+    return tableName;
 }
 
 // Print banner
@@ -13,6 +13,8 @@
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <mutex>
+#include <vector>
 #include <rapidjson/document.h>
 #include <rapidjson/istreamwrapper.h>
 
@@ -22,19 +24,29 @@ using namespace rapidjson;
 // Global variables
 extern bool force;
 extern bool debug;
+extern bool waitForActive;
 extern string appDir;
 extern string tempDir;
 
+// Serializes console output between worker threads
+extern mutex outputMutex;
+
 // Debug logging macro
-#define DEBUG_LOG(msg)                                   \
-    do                                                   \
-    {                                                    \
-        if (debug)                                       \
-            std::cout << "[DEBUG] " << msg << std::endl; \
+#define DEBUG_LOG(msg)                                           \
+    do                                                           \
+    {                                                            \
+        if (debug)                                               \
+        {                                                        \
+            std::lock_guard<std::mutex> debugLock(outputMutex);  \
+            std::cout << "[DEBUG] " << msg << std::endl;         \
+        }                                                        \
     } while (0)
 
 bool tableExists(const string &tableName);
+bool lookupTableSnapshot(const string &tableName, bool &exists);
+void markTableChanged(const string &tableName);
 bool canAccessDynamoDB();
+string extractTableName(const char *json, size_t length);
 string getTableNameFromJson(const string &jsonFilePath);
 void printBanner();
 
@@ -0,0 +1,331 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include "TableProcessor.h"
+#include "TableMigrationTool.h"
+#include "DynamoDBClient.h"
+#include "Task.h"
+#include "TableWaiter.h"
+#include "TableDefinition.h"
+#include "DefinitionSource.h"
+#include "TenantTemplate.h"
+#include "AllocationStats.h"
+#include "AdmissionController.h"
+#include "AimdController.h"
+#include "spdlog/spdlog.h"
+
+namespace
+{
+    // State of one in-flight slot, reused by each definition that runs in it
+    struct TableJob
+    {
+        const DefinitionSource *source = nullptr;
+        TableResult result;
+        TableReport report;
+        TableDefinition definition; // The parsed definition, or a tenant's copy of a template
+    };
+
+    // Attempts per delete or create before a retryable error is reported
+    const int maxCallAttempts = 8;
+
+    // Send a delete or create, retrying throttling, limit and transport
+    // errors with the waiters' backoff. Throttling and limit errors also
+    // lower the concurrency limit; successes slowly raise it again.
+    // ResourceInUseException is retried only when the caller expects the
+    // table to leave a transitional state.
+    Task<DynamoResult> callWithRetry(EventLoop &loop, AimdController &aimd, TableReport &report, const DynamoRequest &request,
+                                     bool retryInUse)
+    {
+        chrono::milliseconds step = tableWaitOptions.initialDelay;
+        for (int attempt = 1;; ++attempt)
+        {
+            DynamoResult result = co_await dynamoCall(loop, request);
+            DynamoErrorClass kind = classifyDynamoError(result);
+            if (kind == DynamoErrorClass::None)
+            {
+                aimd.onSuccess();
+                co_return result;
+            }
+
+            if (kind == DynamoErrorClass::Throttled || kind == DynamoErrorClass::LimitExceeded)
+                aimd.onCongestion(result.errorType);
+
+            bool retryable = kind == DynamoErrorClass::Throttled || kind == DynamoErrorClass::LimitExceeded ||
+                             kind == DynamoErrorClass::Transient || (kind == DynamoErrorClass::ResourceInUse && retryInUse);
+            if (!retryable || attempt >= maxCallAttempts)
+                co_return result;
+
+            string cause = !result.errorType.empty() ? result.errorType
+                           : result.noResponse       ? string("transport error")
+                                                     : "HTTP " + to_string(result.httpStatus);
+            report.debug("Retrying after " + cause +
+                         " (attempt " + to_string(attempt) + " of " + to_string(maxCallAttempts) + ")");
+            co_await sleepFor(loop, jitteredDelay(step));
+            step = min(step * 2, tableWaitOptions.maxDelay);
+        }
+    }
+
+    // Lifecycle of one table: describe, delete and wait until gone (with
+    // --force), create, and optionally wait for ACTIVE. Each remote call or
+    // backoff sleep suspends the coroutine until the event loop resumes it.
+    // Deletes and creates first take a slot from the admission controller
+    // and hold it while the table is DELETING or CREATING.
+    Task<TableOutcome> runTableWorkflow(EventLoop &loop, AdmissionController &admission, AimdController &aimd, const string &jsonDir,
+                                        TableJob &job)
+    {
+        const string &filename = job.result.filename;
+        TableReport &report = job.report;
+
+        report.debug("Processing definition: " + filename);
+
+        // Let through by --keep-going; the pre-flight stage already said why
+        if (!job.source->invalidReason.empty())
+        {
+            report.info("  Processing " + filename + "...", "Processing " + filename + "...");
+            report.error("  - Invalid definition in " + filename + ": " + job.source->invalidReason + ".",
+                         "Invalid definition in " + filename + ": " + job.source->invalidReason + ".");
+            co_return TableOutcome::InvalidDefinition;
+        }
+
+        // Pre-flight already read, decoded and checked the definition; apply
+        // exactly that. A tenant's copy is built from the parsed template.
+        // The request body is read back once the table is known to need it.
+        const DefinitionSource &source = *job.source;
+        if (!source.parsed)
+        {
+            report.info("  Processing " + filename + "...", "Processing " + filename + "...");
+            report.error("  - Invalid definition in " + filename + ": not checked by pre-flight.",
+                         "Invalid definition in " + filename + ": not checked by pre-flight.");
+            co_return TableOutcome::InvalidDefinition;
+        }
+        TableDefinition &definition = job.definition;
+        if (source.tenant.empty())
+            definition = *source.parsed;
+        else
+            expandTenantTemplate(*source.parsed, source.tenant, definition);
+        const string &tableName = definition.tableName;
+        job.result.tableName = tableName;
+
+        report.info("  Processing " + tableName + " table...", "Processing " + tableName + " table...");
+
+        // Check if table already exists, only once per file
+        bool tableAlreadyExists = false;
+        if (!lookupTableSnapshot(tableName, tableAlreadyExists))
+        {
+            DynamoRequest describeRequest = {DynamoOperation::DescribeTable, tableName, "", ""};
+            DynamoResult describe = co_await dynamoCall(loop, describeRequest);
+            tableAlreadyExists = describe.ok();
+        }
+
+        if (tableAlreadyExists && !force)
+        {
+            report.info("  - Skipping " + filename + ", table already exists.", "Skipping " + filename + ", table already exists.");
+            co_return TableOutcome::Skipped;
+        }
+
+        // Read before anything is deleted, so a changed file leaves the table alone
+        string readError;
+        if (!readDefinitionText(jsonDir, source, definition.requestJson, readError))
+        {
+            report.error("  - Could not read " + filename + ": " + readError + ".", "Could not read " + filename + ": " + readError + ".");
+            co_return TableOutcome::Failed;
+        }
+        if (!source.tenant.empty())
+            definition.requestJson = expandTenantBody(definition.requestJson, source.tenant);
+
+        // Delete if force flag set and table exists
+        if (force && tableAlreadyExists)
+        {
+            AdmissionTicket deleteTicket = co_await admission.admit();
+            DynamoRequest deleteRequest = {DynamoOperation::DeleteTable, tableName, "", ""};
+            // In use means the table is still being created or updated
+            Task<DynamoResult> deletion = callWithRetry(loop, aimd, report, deleteRequest, true);
+            DynamoResult deleteResult = co_await deletion;
+            markTableChanged(tableName);
+            if (!deleteResult.ok() && deleteResult.errorType != "ResourceNotFoundException")
+            {
+                report.error("  - Error deleting table for " + filename + ".", "Error deleting table for " + filename + ": " + deleteResult.message);
+                co_return TableOutcome::Failed;
+            }
+
+            // The table stays in DELETING for a while; creating it now would fail with ResourceInUseException
+            Task<WaitResult> deletionWait = waitForTableDeleted(loop, tableName, tableWaitOptions);
+            WaitResult deleted = co_await deletionWait;
+            if (deleted.outcome != WaitOutcome::Reached)
+            {
+                report.error("  - Table for " + filename + " was not deleted: " + deleted.message,
+                             "Table for " + filename + " was not deleted: " + deleted.message);
+                co_return TableOutcome::Failed;
+            }
+            report.info("  + Deleted table for " + filename + ".", "Deleted table for " + filename + ".");
+        }
+
+        // Create table
+        AdmissionTicket createTicket = co_await admission.admit();
+        DynamoRequest createRequest = {DynamoOperation::CreateTable, "", std::move(definition.requestJson), ""};
+        Task<DynamoResult> creation = callWithRetry(loop, aimd, report, createRequest, force);
+        DynamoResult createResult = co_await creation;
+        createRequest.requestJson = string();
+        markTableChanged(tableName);
+
+        // Without --force, in use means someone else created the table since the existence check
+        if (!force && classifyDynamoError(createResult) == DynamoErrorClass::ResourceInUse)
+        {
+            report.info("  - Skipping " + filename + ", table already exists.", "Skipping " + filename + ", table already exists.");
+            co_return TableOutcome::Skipped;
+        }
+
+        if (!createResult.ok())
+        {
+            report.error("  - Error creating table for " + filename + ":", "Error creating table for " + filename + ": " + createResult.message);
+            istringstream errorStream(createResult.message);
+            string line;
+            while (getline(errorStream, line))
+            {
+                report.detail("    " + line);
+            }
+            co_return TableOutcome::Failed;
+        }
+
+        // A limited admission slot can only be freed once the table has left CREATING
+        if ((waitForActive || admission.enabled()) && createResult.tableStatus != "ACTIVE")
+        {
+            Task<WaitResult> activation = waitForTableActive(loop, tableName, tableWaitOptions);
+            WaitResult active = co_await activation;
+            if (active.outcome != WaitOutcome::Reached)
+            {
+                report.error("  - Table for " + filename + " did not become ACTIVE: " + active.message,
+                             "Table for " + filename + " did not become ACTIVE: " + active.message);
+                co_return TableOutcome::Failed;
+            }
+        }
+
+        report.info("  + Created table for " + filename + ".", "Created table for " + filename + ".");
+        co_return tableAlreadyExists ? TableOutcome::Recreated : TableOutcome::Created;
+    }
+}
+
+// Run the check/delete/create sequence for every file on the event loop
+vector<TableResult> processTableFiles(EventLoop &loop, const string &jsonDir, const vector<DefinitionSource> &sources, size_t maxInFlight,
+                                      size_t maxPendingTables)
+{
+    vector<TableResult> results(sources.size());
+    if (sources.empty())
+        return results;
+
+    AdmissionController admission(loop, maxPendingTables);
+    AimdController aimd(admission, maxPendingTables > 0 ? maxPendingTables : maxInFlight);
+
+    size_t slots = min(max<size_t>(maxInFlight, 1), sources.size());
+    vector<unique_ptr<TableJob>> jobs;
+    vector<TableJob *> freeJobs;
+    for (size_t i = 0; i < slots; ++i)
+    {
+        jobs.push_back(make_unique<TableJob>());
+        freeJobs.push_back(jobs.back().get());
+    }
+
+    size_t nextIndex = 0;
+    size_t completed = 0;
+    function<void()> startNext;
+    AllocationStats allocationsBefore = allocationStats();
+
+    // Claim the next definition now, start its workflow on the next loop iteration
+    startNext = [&]()
+    {
+        size_t index = nextIndex++;
+        loop.post([&, index]()
+                  {
+                      TableJob *job = freeJobs.back();
+                      freeJobs.pop_back();
+                      job->source = &sources[index];
+                      job->result.filename = sources[index].label;
+                      job->result.tableName.clear();
+
+                      spawnTask(runTableWorkflow(loop, admission, aimd, jsonDir, *job), [&, index, job](TableOutcome outcome)
+                                {
+                                    job->result.outcome = outcome;
+                                    job->report.flush();
+                                    results[index] = job->result;
+                                    freeJobs.push_back(job);
+                                    ++completed;
+
+                                    // Keep the pipeline full; finish once every table is done
+                                    if (nextIndex < sources.size())
+                                        startNext();
+                                    else if (completed == sources.size())
+                                        loop.stop(); }); });
+    };
+
+    for (size_t i = 0; i < slots; ++i)
+        startNext();
+
+    loop.run();
+
+    logAllocationStats(allocationsBefore, "while processing " + to_string(sources.size()) + " definition(s)");
+
+    if (admission.enabled())
+        DEBUG_LOG("Admission: peak " << admission.peakInFlight() << " pending table(s), " << admission.waitCount() << " wait(s), final limit "
+                                     << admission.currentLimit() << " after " << aimd.decreases() << " decrease(s) and " << aimd.increases()
+                                     << " increase(s).");
+    return results;
+}
+
+// Print the end-of-run summary, in definition order
+void printSummary(const vector<TableResult> &results)
+{
+    size_t created = 0, recreated = 0, skipped = 0, failed = 0, invalid = 0;
+    for (const auto &result : results)
+    {
+        switch (result.outcome)
+        {
+        case TableOutcome::Created:
+            ++created;
+            break;
+        case TableOutcome::Recreated:
+            ++recreated;
+            break;
+        case TableOutcome::Skipped:
+            ++skipped;
+            break;
+        case TableOutcome::Failed:
+            ++failed;
+            break;
+        case TableOutcome::InvalidDefinition:
+            ++invalid;
+            break;
+        }
+    }
+
+    lock_guard<mutex> lock(outputMutex);
+    auto fileLogger = spdlog::get("file_logger");
+
+    cout << endl
+         << "Summary: " << results.size() << " definition(s), " << created << " created, " << recreated << " re-created, "
+         << skipped << " skipped, " << failed << " failed, " << invalid << " invalid." << endl;
+    fileLogger->info("Summary: {} definition(s), {} created, {} re-created, {} skipped, {} failed, {} invalid.",
+                     results.size(), created, recreated, skipped, failed, invalid);
+
+    for (const auto &result : results)
+    {
+        if (result.outcome == TableOutcome::Failed)
+        {
+            cout << "  - Failed: " << result.filename << " (" << result.tableName << ")" << endl;
+            fileLogger->info("Failed: {} ({})", result.filename, result.tableName);
+        }
+        else if (result.outcome == TableOutcome::InvalidDefinition)
+        {
+            cout << "  - Invalid: " << result.filename << endl;
+            fileLogger->info("Invalid: {}", result.filename);
+        }
+    }
+}
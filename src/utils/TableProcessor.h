@@ -0,0 +1,51 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#ifndef TABLE_PROCESSOR_H
+#define TABLE_PROCESSOR_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "EventLoop.h"
+#include "TableReport.h"
+#include "DefinitionSource.h"
+
+using namespace std;
+
+// Final state of one table definition after processing
+enum class TableOutcome
+{
+    Created,
+    Recreated,
+    Skipped,
+    Failed,
+    InvalidDefinition
+};
+
+struct TableResult
+{
+    string filename; // The source's label: file name, file#N for a bundle entry, plus @tenant for a template
+    string tableName;
+    TableOutcome outcome = TableOutcome::Failed;
+};
+
+// Run the check/delete/create sequence for every definition on the event
+// loop, with at most maxInFlight tables in progress at once and at most
+// maxPendingTables (0 for no limit) in CREATING or DELETING state. The
+// definitions pre-flight kept on the sources are applied, with each request
+// body read back from jsonDir only while its table is being created. Each
+// table's output is flushed as one block when it finishes; results are in
+// sources order.
+vector<TableResult> processTableFiles(EventLoop &loop, const string &jsonDir, const vector<DefinitionSource> &sources, size_t maxInFlight,
+                                      size_t maxPendingTables);
+
+// Print the end-of-run summary, in definition order
+void printSummary(const vector<TableResult> &results);
+
+#endif
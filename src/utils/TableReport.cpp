@@ -0,0 +1,69 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#include "TableReport.h"
+#include "TableMigrationTool.h"
+#include "spdlog/spdlog.h"
+
+void TableReport::info(const string &consoleLine, const string &logMessage)
+{
+    entries.push_back({Kind::Info, consoleLine, logMessage});
+}
+
+void TableReport::error(const string &consoleLine, const string &logMessage)
+{
+    entries.push_back({Kind::Error, consoleLine, logMessage});
+}
+
+void TableReport::detail(const string &consoleLine)
+{
+    entries.push_back({Kind::Detail, consoleLine, ""});
+}
+
+void TableReport::debug(const string &message)
+{
+    entries.push_back({Kind::Debug, "[DEBUG] " + message, message});
+}
+
+// Write all buffered output in one block and clear the buffer
+void TableReport::flush()
+{
+    lock_guard<mutex> lock(outputMutex);
+    auto fileLogger = spdlog::get("file_logger");
+
+    for (const auto &entry : entries)
+    {
+        switch (entry.kind)
+        {
+        case Kind::Info:
+            cout << entry.consoleLine << endl;
+            if (fileLogger)
+                fileLogger->info(entry.logMessage);
+            break;
+
+        case Kind::Error:
+            cerr << entry.consoleLine << endl;
+            if (fileLogger)
+                fileLogger->error(entry.logMessage);
+            break;
+
+        case Kind::Detail:
+            cerr << entry.consoleLine << endl;
+            break;
+
+        case Kind::Debug:
+            if (::debug)
+                cout << entry.consoleLine << endl;
+            if (fileLogger)
+                fileLogger->debug(entry.logMessage);
+            break;
+        }
+    }
+
+    entries.clear();
+}
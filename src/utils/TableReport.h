@@ -0,0 +1,56 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#ifndef TABLE_REPORT_H
+#define TABLE_REPORT_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Buffers the console and file_logger output produced while processing one
+// table, so that concurrent workers never interleave their lines.
+class TableReport
+{
+public:
+    // Console line on stdout, message at info level in the log file
+    void info(const string &consoleLine, const string &logMessage);
+
+    // Console line on stderr, message at error level in the log file
+    void error(const string &consoleLine, const string &logMessage);
+
+    // Console line on stderr only (e.g. captured CLI output)
+    void detail(const string &consoleLine);
+
+    // Debug line, printed only when debug output is enabled
+    void debug(const string &message);
+
+    // Write all buffered output in one block and clear the buffer
+    void flush();
+
+private:
+    enum class Kind
+    {
+        Info,
+        Error,
+        Detail,
+        Debug
+    };
+
+    struct Entry
+    {
+        Kind kind;
+        string consoleLine;
+        string logMessage;
+    };
+
+    vector<Entry> entries;
+};
+
+#endif
@@ -0,0 +1,110 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#include <algorithm>
+#include <random>
+#include "TableWaiter.h"
+#include "DynamoDBClient.h"
+#include "TableMigrationTool.h"
+
+WaitOptions tableWaitOptions;
+
+namespace
+{
+    enum class PollState
+    {
+        Reached,
+        Pending,
+        Failed
+    };
+
+    // Errors that say nothing about the table's state and are worth retrying
+    bool isTransient(const DynamoResult &result)
+    {
+        DynamoErrorClass kind = classifyDynamoError(result);
+        return kind == DynamoErrorClass::Throttled || kind == DynamoErrorClass::LimitExceeded || kind == DynamoErrorClass::Transient;
+    }
+
+    // Shared polling loop; classify maps one DescribeTable result to a state
+    template <typename Classify>
+    Task<WaitResult> pollTable(EventLoop &loop, string tableName, WaitOptions options, Classify classify)
+    {
+        WaitResult waitResult;
+        auto deadline = chrono::steady_clock::now() + options.timeout;
+        chrono::milliseconds step = options.initialDelay;
+
+        while (true)
+        {
+            DynamoRequest describeRequest = {DynamoOperation::DescribeTable, tableName, "", ""};
+            DynamoResult describe = co_await dynamoCall(loop, describeRequest);
+            ++waitResult.polls;
+
+            PollState state = classify(describe);
+            if (state == PollState::Reached)
+            {
+                waitResult.outcome = WaitOutcome::Reached;
+                co_return waitResult;
+            }
+            if (state == PollState::Failed)
+            {
+                waitResult.outcome = WaitOutcome::Failed;
+                waitResult.message = describe.message;
+                co_return waitResult;
+            }
+
+            auto now = chrono::steady_clock::now();
+            if (now >= deadline)
+            {
+                waitResult.outcome = WaitOutcome::TimedOut;
+                waitResult.message = "Timed out after " + to_string(waitResult.polls) + " poll(s) waiting for " + tableName + ".";
+                co_return waitResult;
+            }
+
+            auto remaining = chrono::duration_cast<chrono::milliseconds>(deadline - now);
+            co_await sleepFor(loop, min(jitteredDelay(step), remaining));
+            step = min(step * 2, options.maxDelay);
+        }
+    }
+}
+
+// Pick a random point in the upper half of a backoff step
+chrono::milliseconds jitteredDelay(chrono::milliseconds step)
+{
+    thread_local mt19937 generator(random_device{}());
+    uniform_int_distribution<long long> distribution(step.count() / 2, step.count());
+    return chrono::milliseconds(distribution(generator));
+}
+
+// Poll DescribeTable until the table no longer exists
+Task<WaitResult> waitForTableDeleted(EventLoop &loop, string tableName, WaitOptions options)
+{
+    DEBUG_LOG("Waiting for " << tableName << " to be deleted.");
+    Task<WaitResult> polling = pollTable(loop, tableName, options, [](const DynamoResult &describe)
+                                         {
+                                             if (describe.ok())
+                                                 return PollState::Pending;
+                                             if (describe.errorType == "ResourceNotFoundException")
+                                                 return PollState::Reached;
+                                             return isTransient(describe) ? PollState::Pending : PollState::Failed; });
+    co_return co_await polling;
+}
+
+// Poll DescribeTable until the table is ACTIVE
+Task<WaitResult> waitForTableActive(EventLoop &loop, string tableName, WaitOptions options)
+{
+    DEBUG_LOG("Waiting for " << tableName << " to become ACTIVE.");
+    Task<WaitResult> polling = pollTable(loop, tableName, options, [](const DynamoResult &describe)
+                                         {
+                                             if (describe.ok())
+                                                 return describe.tableStatus == "ACTIVE" ? PollState::Reached : PollState::Pending;
+                                             // A just-created table can briefly be invisible to DescribeTable
+                                             if (describe.errorType == "ResourceNotFoundException")
+                                                 return PollState::Pending;
+                                             return isTransient(describe) ? PollState::Pending : PollState::Failed; });
+    co_return co_await polling;
+}
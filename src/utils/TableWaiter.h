@@ -0,0 +1,55 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#ifndef TABLE_WAITER_H
+#define TABLE_WAITER_H
+
+#include <chrono>
+#include <string>
+#include "EventLoop.h"
+#include "Task.h"
+
+using namespace std;
+
+// Polling schedule for a waiter: exponential backoff with jitter between
+// initialDelay and maxDelay, giving up after timeout
+struct WaitOptions
+{
+    chrono::milliseconds initialDelay{250};
+    chrono::milliseconds maxDelay{5000};
+    chrono::milliseconds timeout{300000};
+};
+
+enum class WaitOutcome
+{
+    Reached,  // The table reached the awaited state
+    TimedOut, // The timeout passed first
+    Failed    // DescribeTable failed with a non-retryable error
+};
+
+struct WaitResult
+{
+    WaitOutcome outcome = WaitOutcome::Failed;
+    string message;
+    int polls = 0;
+};
+
+// Options used by the per-table workflow, set from the command line
+extern WaitOptions tableWaitOptions;
+
+// Pick the next sleep: a random point in the upper half of the backoff step,
+// so tables that started together drift apart
+chrono::milliseconds jitteredDelay(chrono::milliseconds step);
+
+// Poll DescribeTable until the table no longer exists
+Task<WaitResult> waitForTableDeleted(EventLoop &loop, string tableName, WaitOptions options);
+
+// Poll DescribeTable until the table is ACTIVE
+Task<WaitResult> waitForTableActive(EventLoop &loop, string tableName, WaitOptions options);
+
+#endif
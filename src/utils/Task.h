@@ -0,0 +1,184 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#ifndef TASK_H
+#define TASK_H
+
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+#include "EventLoop.h"
+
+using namespace std;
+
+// Lazily started coroutine producing a T. Awaiting a Task starts it and
+// resumes the awaiter when it finishes. Tasks never switch threads on their
+// own: they resume from EventLoop callbacks, so the loop is their executor.
+template <typename T>
+class Task;
+
+namespace detail
+{
+    struct TaskPromiseBase
+    {
+        coroutine_handle<> continuation;
+        exception_ptr error;
+
+        suspend_always initial_suspend() noexcept { return {}; }
+
+        // Hand control straight back to whoever awaited us
+        struct FinalAwaiter
+        {
+            bool await_ready() noexcept { return false; }
+
+            template <typename Promise>
+            coroutine_handle<> await_suspend(coroutine_handle<Promise> finished) noexcept
+            {
+                coroutine_handle<> continuation = finished.promise().continuation;
+                return continuation ? continuation : noop_coroutine();
+            }
+
+            void await_resume() noexcept {}
+        };
+
+        FinalAwaiter final_suspend() noexcept { return {}; }
+
+        void unhandled_exception() { error = current_exception(); }
+    };
+
+    template <typename T>
+    struct TaskPromise : TaskPromiseBase
+    {
+        optional<T> value;
+
+        Task<T> get_return_object();
+        void return_value(T result) { value = std::move(result); }
+
+        T take()
+        {
+            if (error)
+                rethrow_exception(error);
+            return std::move(*value);
+        }
+    };
+
+    template <>
+    struct TaskPromise<void> : TaskPromiseBase
+    {
+        Task<void> get_return_object();
+        void return_void() {}
+
+        void take()
+        {
+            if (error)
+                rethrow_exception(error);
+        }
+    };
+}
+
+template <typename T>
+class Task
+{
+public:
+    using promise_type = detail::TaskPromise<T>;
+    using Handle = coroutine_handle<promise_type>;
+
+    explicit Task(Handle handle) : handle(handle) {}
+    Task(Task &&other) noexcept : handle(exchange(other.handle, nullptr)) {}
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+
+    ~Task()
+    {
+        if (handle)
+            handle.destroy();
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    coroutine_handle<> await_suspend(coroutine_handle<> awaiter) noexcept
+    {
+        handle.promise().continuation = awaiter;
+        return handle;
+    }
+
+    T await_resume() { return handle.promise().take(); }
+
+private:
+    Handle handle;
+};
+
+namespace detail
+{
+    template <typename T>
+    Task<T> TaskPromise<T>::get_return_object()
+    {
+        return Task<T>(coroutine_handle<TaskPromise<T>>::from_promise(*this));
+    }
+
+    inline Task<void> TaskPromise<void>::get_return_object()
+    {
+        return Task<void>(coroutine_handle<TaskPromise<void>>::from_promise(*this));
+    }
+
+    // Fire-and-forget coroutine that frees itself when it completes
+    struct DetachedTask
+    {
+        struct promise_type
+        {
+            DetachedTask get_return_object() { return {}; }
+            suspend_never initial_suspend() noexcept { return {}; }
+            suspend_never final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { terminate(); }
+        };
+    };
+
+    template <typename T, typename Done>
+    DetachedTask runDetached(Task<T> task, Done done)
+    {
+        done(co_await task);
+    }
+}
+
+// Start task now and call done with its result when it completes
+template <typename T, typename Done>
+void spawnTask(Task<T> task, Done done)
+{
+    detail::runDetached(std::move(task), std::move(done));
+}
+
+// co_await sleepFor(loop, delay) suspends the coroutine for delay
+class SleepAwaiter
+{
+public:
+    SleepAwaiter(EventLoop &loop, chrono::milliseconds delay) : loop(loop), delay(delay) {}
+
+    bool await_ready() const noexcept { return delay.count() <= 0; }
+
+    void await_suspend(coroutine_handle<> waiting)
+    {
+        loop.runAfter(delay, [waiting]
+                      { waiting.resume(); });
+    }
+
+    void await_resume() const noexcept {}
+
+private:
+    EventLoop &loop;
+    chrono::milliseconds delay;
+};
+
+inline SleepAwaiter sleepFor(EventLoop &loop, chrono::milliseconds delay)
+{
+    return SleepAwaiter(loop, delay);
+}
+
+#endif
@@ -0,0 +1,133 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#include <cstring>
+#include <fstream>
+#include <unordered_set>
+#include "TenantTemplate.h"
+
+const char *const tenantPlaceholder = "{{tenant}}";
+
+namespace
+{
+    const size_t placeholderLength = strlen(tenantPlaceholder);
+
+    bool isTenantChar(char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-' || c == '.';
+    }
+
+    string trim(const string &text)
+    {
+        size_t first = text.find_first_not_of(" \t\r");
+        if (first == string::npos)
+            return "";
+        size_t last = text.find_last_not_of(" \t\r");
+        return text.substr(first, last - first + 1);
+    }
+
+    // Replace every placeholder in text, in place
+    void substitute(string &text, const string &tenant)
+    {
+        size_t at = text.find(tenantPlaceholder);
+        while (at != string::npos)
+        {
+            text.replace(at, placeholderLength, tenant);
+            at = text.find(tenantPlaceholder, at + tenant.size());
+        }
+    }
+}
+
+// Read a tenant list from a comma-separated spec or an @file
+bool loadTenantList(const string &spec, vector<string> &tenants, string &error)
+{
+    vector<string> names;
+    if (!spec.empty() && spec[0] == '@')
+    {
+        ifstream file(spec.substr(1));
+        if (!file)
+        {
+            error = "Could not open tenant list " + spec.substr(1);
+            return false;
+        }
+        string line;
+        while (getline(file, line))
+            names.push_back(trim(line.substr(0, line.find('#'))));
+    }
+    else
+    {
+        size_t start = 0;
+        while (start <= spec.size())
+        {
+            size_t comma = spec.find(',', start);
+            if (comma == string::npos)
+                comma = spec.size();
+            names.push_back(trim(spec.substr(start, comma - start)));
+            start = comma + 1;
+        }
+    }
+
+    unordered_set<string> seen;
+    tenants.clear();
+    for (const auto &name : names)
+    {
+        if (name.empty())
+            continue;
+        for (char c : name)
+        {
+            if (!isTenantChar(c))
+            {
+                error = "Tenant name '" + name + "' may only contain a-z, A-Z, 0-9, '_', '-' and '.'";
+                return false;
+            }
+        }
+        if (seen.insert(name).second)
+            tenants.push_back(name);
+    }
+
+    if (tenants.empty())
+    {
+        error = "The tenant list is empty";
+        return false;
+    }
+    return true;
+}
+
+// Whether a decoded definition is a template to expand per tenant
+bool isTenantTemplate(const TableDefinition &definition)
+{
+    return definition.tableName.find(tenantPlaceholder) != string::npos;
+}
+
+// The table name a template gets for one tenant
+string expandTenantName(const string &name, const string &tenant)
+{
+    string expanded = name;
+    substitute(expanded, tenant);
+    return expanded;
+}
+
+// A template's request body for one tenant
+string expandTenantBody(const string &body, const string &tenant)
+{
+    string expanded = body;
+    substitute(expanded, tenant);
+    return expanded;
+}
+
+// One tenant's copy of a parsed template
+void expandTenantTemplate(const TableDefinition &parsedTemplate, const string &tenant, TableDefinition &definition)
+{
+    definition = parsedTemplate;
+    substitute(definition.tableName, tenant);
+    for (auto &index : definition.globalSecondaryIndexes)
+        substitute(index.indexName, tenant);
+    for (auto &index : definition.localSecondaryIndexes)
+        substitute(index.indexName, tenant);
+    substitute(definition.requestJson, tenant);
+}
@@ -0,0 +1,41 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#ifndef TENANT_TEMPLATE_H
+#define TENANT_TEMPLATE_H
+
+#include <string>
+#include <vector>
+#include "TableDefinition.h"
+
+using namespace std;
+
+// Marks a template definition when it appears in TableName. Every
+// occurrence in the definition, including index names, is replaced by the
+// tenant name.
+extern const char *const tenantPlaceholder;
+
+// Read a tenant list: comma-separated names, or @file with one name per
+// line ('#' starts a comment). Names may only use the characters allowed
+// in table names, so they can be substituted into JSON text as is.
+bool loadTenantList(const string &spec, vector<string> &tenants, string &error);
+
+// Whether a decoded definition is a template to expand per tenant
+bool isTenantTemplate(const TableDefinition &definition);
+
+// The table name a template gets for one tenant
+string expandTenantName(const string &name, const string &tenant);
+
+// A template's request body for one tenant
+string expandTenantBody(const string &body, const string &tenant);
+
+// One tenant's copy of a parsed template, with the names and the request
+// body substituted; nothing is parsed again
+void expandTenantTemplate(const TableDefinition &parsedTemplate, const string &tenant, TableDefinition &definition);
+
+#endif
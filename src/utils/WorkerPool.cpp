@@ -0,0 +1,78 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(size_t threadCount)
+{
+    if (threadCount == 0)
+        threadCount = 1;
+
+    workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i)
+        workers.emplace_back(&WorkerPool::workerLoop, this, i);
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        lock_guard<mutex> lock(queueMutex);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+
+    for (auto &worker : workers)
+        worker.join();
+}
+
+// Queue a task for execution
+void WorkerPool::submit(function<void(size_t workerId)> task)
+{
+    {
+        lock_guard<mutex> lock(queueMutex);
+        tasks.push_back(std::move(task));
+    }
+    taskAvailable.notify_one();
+}
+
+// Block until every submitted task has finished
+void WorkerPool::wait()
+{
+    unique_lock<mutex> lock(queueMutex);
+    tasksDone.wait(lock, [this]
+                   { return tasks.empty() && activeTasks == 0; });
+}
+
+// Pull tasks until the pool is destroyed
+void WorkerPool::workerLoop(size_t workerId)
+{
+    while (true)
+    {
+        function<void(size_t)> task;
+        {
+            unique_lock<mutex> lock(queueMutex);
+            taskAvailable.wait(lock, [this]
+                               { return stopping || !tasks.empty(); });
+            if (tasks.empty())
+                return;
+
+            task = std::move(tasks.front());
+            tasks.pop_front();
+            ++activeTasks;
+        }
+
+        task(workerId);
+
+        {
+            lock_guard<mutex> lock(queueMutex);
+            --activeTasks;
+            if (tasks.empty() && activeTasks == 0)
+                tasksDone.notify_all();
+        }
+    }
+}
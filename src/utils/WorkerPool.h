@@ -0,0 +1,54 @@
+/*!
+ * DynamoDB Table Migration Tool
+ * https://vmgware.dev/
+ *
+ * Copyright (c) 2023 VMG Ware
+ * MIT Licensed
+ */
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Bounded pool of worker threads pulling tasks from a shared queue.
+// Each task receives the index of the worker running it, so callers can keep
+// per-worker scratch state without locking.
+class WorkerPool
+{
+public:
+    explicit WorkerPool(size_t threadCount);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    // Queue a task for execution
+    void submit(function<void(size_t workerId)> task);
+
+    // Block until every submitted task has finished
+    void wait();
+
+    size_t size() const { return workers.size(); }
+
+private:
+    void workerLoop(size_t workerId);
+
+    vector<thread> workers;
+    deque<function<void(size_t)>> tasks;
+    mutex queueMutex;
+    condition_variable taskAvailable;
+    condition_variable tasksDone;
+    size_t activeTasks = 0;
+    bool stopping = false;
+};
+
+#endif